@@ -0,0 +1,37 @@
+#ifndef BIDSTACK_GIANTSWARM_CONCURRENTCACHEADAPTER_HPP
+#define BIDSTACK_GIANTSWARM_CONCURRENTCACHEADAPTER_HPP
+
+#include <QString>
+
+#include "../deps/cache/abstractcacheadapter.hpp"
+
+namespace Bidstack {
+    namespace Giantswarm {
+
+        namespace Caches {
+
+            /**
+             * Cache adapter whose methods may be called from several
+             * threads at once. The client uses adapters implementing this
+             * interface directly and wraps all others in a
+             * LockingCacheAdapter.
+             */
+            class ConcurrentCacheAdapter : public Bidstack::Cache::AbstractCacheAdapter {
+            public:
+                virtual ~ConcurrentCacheAdapter() {}
+
+            public:
+                /**
+                 * Combined has() and fetch(), so that an entry cannot be
+                 * evicted between the two. Returns whether the key was found
+                 * and stores its value in value.
+                 */
+                virtual bool lookup(QString key, QString *value) =0;
+            };
+
+        };
+
+    };
+};
+
+#endif
@@ -0,0 +1,40 @@
+#include <QMutexLocker>
+
+#include "lockingcacheadapter.hpp"
+
+using namespace Bidstack::Cache;
+using namespace Bidstack::Giantswarm::Caches;
+
+LockingCacheAdapter::LockingCacheAdapter(AbstractCacheAdapter *adapter) {
+    m_adapter = adapter;
+}
+
+bool LockingCacheAdapter::has(QString key) {
+    QMutexLocker locker(&m_mutex);
+    return m_adapter->has(key);
+}
+
+QString LockingCacheAdapter::fetch(QString key) {
+    QMutexLocker locker(&m_mutex);
+    return m_adapter->fetch(key);
+}
+
+void LockingCacheAdapter::store(QString key, QString value) {
+    QMutexLocker locker(&m_mutex);
+    m_adapter->store(key, value);
+}
+
+bool LockingCacheAdapter::lookup(QString key, QString *value) {
+    QMutexLocker locker(&m_mutex);
+
+    if (!m_adapter->has(key)) {
+        return false;
+    }
+
+    *value = m_adapter->fetch(key);
+    return true;
+}
+
+AbstractCacheAdapter* LockingCacheAdapter::adapter() const {
+    return m_adapter;
+}
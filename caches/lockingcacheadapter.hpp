@@ -0,0 +1,41 @@
+#ifndef BIDSTACK_GIANTSWARM_LOCKINGCACHEADAPTER_HPP
+#define BIDSTACK_GIANTSWARM_LOCKINGCACHEADAPTER_HPP
+
+#include <QMutex>
+#include <QString>
+
+#include "concurrentcacheadapter.hpp"
+
+namespace Bidstack {
+    namespace Giantswarm {
+
+        namespace Caches {
+
+            /**
+             * Makes any cache adapter safe to share between threads by
+             * serializing all calls to it. The wrapped adapter is not
+             * owned.
+             */
+            class LockingCacheAdapter : public ConcurrentCacheAdapter {
+            public:
+                LockingCacheAdapter(Bidstack::Cache::AbstractCacheAdapter *adapter);
+
+            public:
+                bool has(QString key);
+                QString fetch(QString key);
+                void store(QString key, QString value);
+                bool lookup(QString key, QString *value);
+
+                Bidstack::Cache::AbstractCacheAdapter* adapter() const;
+
+            private:
+                Bidstack::Cache::AbstractCacheAdapter *m_adapter;
+                QMutex m_mutex;
+            };
+
+        };
+
+    };
+};
+
+#endif
@@ -0,0 +1,252 @@
+#include <QMutexLocker>
+
+#include "memorycacheadapter.hpp"
+
+using namespace Bidstack::Giantswarm::Caches;
+
+// Rough cost of a node and its hash table slot beyond the string data.
+static const qint64 NODE_OVERHEAD = 64;
+
+MemoryCacheAdapter::Statistics::Statistics() {
+    hits = 0;
+    misses = 0;
+    evictions = 0;
+    entries = 0;
+    size = 0;
+}
+
+MemoryCacheAdapter::Shard::Shard() {
+    head = 0;
+    tail = 0;
+    size = 0;
+    hits = 0;
+    misses = 0;
+    evictions = 0;
+}
+
+/**
+ * Inserts the node as the most recently used one.
+ */
+void MemoryCacheAdapter::Shard::link(Node *node) {
+    node->prev = 0;
+    node->next = head;
+
+    if (head) {
+        head->prev = node;
+    }
+
+    head = node;
+
+    if (!tail) {
+        tail = node;
+    }
+}
+
+void MemoryCacheAdapter::Shard::unlink(Node *node) {
+    if (node->prev) {
+        node->prev->next = node->next;
+    } else {
+        head = node->next;
+    }
+
+    if (node->next) {
+        node->next->prev = node->prev;
+    } else {
+        tail = node->prev;
+    }
+
+    node->prev = 0;
+    node->next = 0;
+}
+
+/**
+ * Returns the size the node took up.
+ */
+qint64 MemoryCacheAdapter::Shard::erase(Node *node) {
+    qint64 erased = node->size;
+
+    unlink(node);
+    nodes.remove(node->key);
+    size -= erased;
+    delete node;
+
+    return erased;
+}
+
+MemoryCacheAdapter::MemoryCacheAdapter(qint64 maxSize, int shards) {
+    m_maxSize = qMax((qint64) 0, maxSize);
+    m_size = 0;
+    m_clock.start();
+
+    int count = qMax(1, shards);
+    for (int i = 0; i < count; ++i) {
+        m_shards.append(new Shard());
+    }
+}
+
+MemoryCacheAdapter::~MemoryCacheAdapter() {
+    clear();
+    qDeleteAll(m_shards);
+}
+
+bool MemoryCacheAdapter::has(QString key) {
+    Shard *s = shard(key);
+
+    QMutexLocker locker(&s->mutex);
+    return s->nodes.contains(key);
+}
+
+QString MemoryCacheAdapter::fetch(QString key) {
+    QString value;
+    lookup(key, &value);
+    return value;
+}
+
+void MemoryCacheAdapter::store(QString key, QString value) {
+    qint64 size = (qint64) (key.size() + value.size()) * sizeof(QChar) + NODE_OVERHEAD;
+
+    if (size > m_maxSize) {
+        remove(key);
+        return;
+    }
+
+    Shard *s = shard(key);
+    QMutexLocker locker(&s->mutex);
+
+    qint64 delta = size;
+
+    Node *node = s->nodes.value(key, 0);
+    if (node) {
+        delta -= s->erase(node);
+    }
+
+    node = new Node();
+    node->key = key;
+    node->value = value;
+    node->size = size;
+    node->usedAt = m_clock.elapsed();
+
+    s->link(node);
+    s->nodes.insert(key, node);
+    s->size += size;
+
+    addSize(delta);
+    locker.unlock();
+
+    evict();
+}
+
+bool MemoryCacheAdapter::lookup(QString key, QString *value) {
+    Shard *s = shard(key);
+
+    QMutexLocker locker(&s->mutex);
+
+    Node *node = s->nodes.value(key, 0);
+    if (!node) {
+        ++s->misses;
+        return false;
+    }
+
+    if (node != s->head) {
+        s->unlink(node);
+        s->link(node);
+    }
+
+    node->usedAt = m_clock.elapsed();
+
+    ++s->hits;
+    *value = node->value;
+    return true;
+}
+
+void MemoryCacheAdapter::remove(QString key) {
+    Shard *s = shard(key);
+
+    QMutexLocker locker(&s->mutex);
+
+    Node *node = s->nodes.value(key, 0);
+    if (node) {
+        addSize(-s->erase(node));
+    }
+}
+
+void MemoryCacheAdapter::clear() {
+    foreach (Shard *s, m_shards) {
+        QMutexLocker locker(&s->mutex);
+
+        while (s->tail) {
+            addSize(-s->erase(s->tail));
+        }
+    }
+}
+
+qint64 MemoryCacheAdapter::maxSize() const {
+    return m_maxSize;
+}
+
+/**
+ * Sums up the counters of all shards. Shards are read one after another,
+ * so the totals are not an atomic snapshot while other threads are busy.
+ */
+MemoryCacheAdapter::Statistics MemoryCacheAdapter::statistics() const {
+    Statistics statistics;
+
+    foreach (Shard *s, m_shards) {
+        QMutexLocker locker(&s->mutex);
+
+        statistics.hits += s->hits;
+        statistics.misses += s->misses;
+        statistics.evictions += s->evictions;
+        statistics.entries += s->nodes.size();
+        statistics.size += s->size;
+    }
+
+    return statistics;
+}
+
+MemoryCacheAdapter::Shard* MemoryCacheAdapter::shard(const QString& key) const {
+    return m_shards.at(qHash(key) % (uint) m_shards.size());
+}
+
+void MemoryCacheAdapter::addSize(qint64 delta) {
+    QMutexLocker locker(&m_sizeMutex);
+    m_size += delta;
+}
+
+/**
+ * Evicts the least recently used entries across all shards until the
+ * cache fits its budget again. Only one shard is locked at a time;
+ * concurrent stores may evict a little more than necessary.
+ */
+void MemoryCacheAdapter::evict() {
+    forever {
+        QMutexLocker sizeLocker(&m_sizeMutex);
+        if (m_size <= m_maxSize) {
+            return;
+        }
+        sizeLocker.unlock();
+
+        Shard *victim = 0;
+        qint64 oldest = 0;
+
+        foreach (Shard *s, m_shards) {
+            QMutexLocker locker(&s->mutex);
+
+            if (s->tail && (!victim || s->tail->usedAt < oldest)) {
+                victim = s;
+                oldest = s->tail->usedAt;
+            }
+        }
+
+        if (!victim) {
+            return;
+        }
+
+        QMutexLocker locker(&victim->mutex);
+
+        if (victim->tail) {
+            addSize(-victim->erase(victim->tail));
+            ++victim->evictions;
+        }
+    }
+}
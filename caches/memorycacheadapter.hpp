@@ -0,0 +1,108 @@
+#ifndef BIDSTACK_GIANTSWARM_MEMORYCACHEADAPTER_HPP
+#define BIDSTACK_GIANTSWARM_MEMORYCACHEADAPTER_HPP
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+#include "concurrentcacheadapter.hpp"
+
+namespace Bidstack {
+    namespace Giantswarm {
+
+        namespace Caches {
+
+            const qint64 DEFAULT_MEMORY_CACHE_MAX_SIZE = 32 * 1024 * 1024;
+            const int DEFAULT_MEMORY_CACHE_SHARDS = 16;
+
+            /**
+             * In-process LRU cache for long-lived processes.
+             *
+             * Keys are spread over a fixed number of shards by their hash.
+             * Each shard has its own lock, hash table and intrusive LRU list,
+             * so threads working on different keys rarely wait for each
+             * other. The byte budget applies to the cache as a whole: once a
+             * store exceeds it, the least recently used entries of all
+             * shards are evicted, comparing the tails of the shards' lists.
+             * Sizes count the UTF-16 bytes of keys and values plus a fixed
+             * overhead per entry; values larger than the budget are not
+             * cached.
+             */
+            class MemoryCacheAdapter : public ConcurrentCacheAdapter {
+            public:
+                struct Statistics {
+                    Statistics();
+
+                    qint64 hits;
+                    qint64 misses;
+                    qint64 evictions;
+                    qint64 entries;
+                    qint64 size;
+                };
+
+            public:
+                MemoryCacheAdapter(qint64 maxSize = DEFAULT_MEMORY_CACHE_MAX_SIZE, int shards = DEFAULT_MEMORY_CACHE_SHARDS);
+                ~MemoryCacheAdapter();
+
+            public:
+                bool has(QString key);
+                QString fetch(QString key);
+                void store(QString key, QString value);
+                bool lookup(QString key, QString *value);
+
+                void remove(QString key);
+                void clear();
+
+                qint64 maxSize() const;
+                Statistics statistics() const;
+
+            private:
+                struct Node {
+                    QString key;
+                    QString value;
+                    qint64 size;
+                    qint64 usedAt;
+                    Node *prev;
+                    Node *next;
+                };
+
+                struct Shard {
+                    Shard();
+
+                    mutable QMutex mutex;
+                    QHash<QString, Node*> nodes;
+                    Node *head;
+                    Node *tail;
+                    qint64 size;
+
+                    qint64 hits;
+                    qint64 misses;
+                    qint64 evictions;
+
+                    void link(Node *node);
+                    void unlink(Node *node);
+                    qint64 erase(Node *node);
+                };
+
+                Shard* shard(const QString& key) const;
+
+                void addSize(qint64 delta);
+                void evict();
+
+            private:
+                QVector<Shard*> m_shards;
+                qint64 m_maxSize;
+                QElapsedTimer m_clock;
+
+                QMutex m_sizeMutex;
+                qint64 m_size;
+            };
+
+        };
+
+    };
+};
+
+#endif
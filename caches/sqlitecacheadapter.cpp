@@ -0,0 +1,171 @@
+#include <QDateTime>
+#include <QMutexLocker>
+
+#include "sqlitecacheadapter.hpp"
+
+using namespace Bidstack::Giantswarm::Caches;
+using namespace Bidstack::Giantswarm::Repositories;
+
+SqliteCacheAdapter::SqliteCacheAdapter(QSqlDatabase& database) {
+    m_repository = new CacheRepository(database);
+    m_ttl = DEFAULT_SQLITE_CACHE_TTL;
+    m_batchSize = DEFAULT_SQLITE_CACHE_BATCH_SIZE;
+    m_flushInterval = DEFAULT_SQLITE_CACHE_FLUSH_INTERVAL;
+}
+
+SqliteCacheAdapter::~SqliteCacheAdapter() {
+    flush();
+    delete m_repository;
+}
+
+bool SqliteCacheAdapter::has(QString key) {
+    QMutexLocker locker(&m_mutex);
+    if (m_pending.contains(key) || m_flushing.contains(key)) {
+        return true;
+    }
+    locker.unlock();
+
+    return m_repository->has(key, QDateTime::currentMSecsSinceEpoch());
+}
+
+QString SqliteCacheAdapter::fetch(QString key) {
+    QString value;
+    lookup(key, &value);
+    return value;
+}
+
+void SqliteCacheAdapter::store(QString key, QString value) {
+    QMutexLocker locker(&m_mutex);
+
+    if (m_pending.isEmpty() && m_accessed.isEmpty()) {
+        m_pendingSince.start();
+    }
+
+    m_pending.insert(key, value);
+    flushIfDue(locker);
+}
+
+bool SqliteCacheAdapter::lookup(QString key, QString *value) {
+    QMutexLocker locker(&m_mutex);
+
+    QMap<QString, QString>::const_iterator it = m_pending.constFind(key);
+    if (it != m_pending.constEnd()) {
+        *value = it.value();
+        return true;
+    }
+
+    it = m_flushing.constFind(key);
+    if (it != m_flushing.constEnd()) {
+        *value = it.value();
+        return true;
+    }
+
+    locker.unlock();
+
+    if (!m_repository->fetch(key, QDateTime::currentMSecsSinceEpoch(), value)) {
+        return false;
+    }
+
+    touch(key);
+    return true;
+}
+
+/**
+ * Writes all buffered stores and access times to the database, waiting
+ * for a flush already in progress.
+ */
+bool SqliteCacheAdapter::flush() {
+    QMutexLocker flushLocker(&m_flushMutex);
+    return writePending();
+}
+
+bool SqliteCacheAdapter::clear() {
+    QMutexLocker flushLocker(&m_flushMutex);
+
+    QMutexLocker locker(&m_mutex);
+    m_pending.clear();
+    m_accessed.clear();
+    locker.unlock();
+
+    return m_repository->clear();
+}
+
+void SqliteCacheAdapter::setTtl(int seconds) {
+    m_ttl = qMax(1, seconds);
+}
+
+void SqliteCacheAdapter::setMaxSize(qint64 bytes) {
+    m_repository->setMaxSize(bytes);
+}
+
+void SqliteCacheAdapter::setBatchSize(int count) {
+    m_batchSize = qMax(1, count);
+}
+
+void SqliteCacheAdapter::setFlushInterval(int msecs) {
+    m_flushInterval = qMax(0, msecs);
+}
+
+void SqliteCacheAdapter::touch(QString key) {
+    QMutexLocker locker(&m_mutex);
+
+    if (m_pending.isEmpty() && m_accessed.isEmpty()) {
+        m_pendingSince.start();
+    }
+
+    // Only recorded; writing is left to store() and flush(), so a hit
+    // never waits for a transaction.
+    m_accessed.insert(key);
+}
+
+/**
+ * Leaves the buffer to a flush which is already running rather than
+ * waiting for it.
+ */
+void SqliteCacheAdapter::flushIfDue(QMutexLocker& locker) {
+    bool full = m_pending.size() + m_accessed.size() >= m_batchSize;
+    bool old = m_pendingSince.isValid() && m_pendingSince.elapsed() >= m_flushInterval;
+
+    if (!full && !old) {
+        return;
+    }
+
+    locker.unlock();
+
+    if (m_flushMutex.tryLock()) {
+        writePending();
+        m_flushMutex.unlock();
+    }
+}
+
+/**
+ * Takes the buffer and writes it outside of m_mutex, so the cache stays
+ * usable during the transaction. Callers hold m_flushMutex, which keeps
+ * flushes in order and m_flushing to one batch.
+ */
+bool SqliteCacheAdapter::writePending() {
+    QMutexLocker locker(&m_mutex);
+
+    if (m_pending.isEmpty() && m_accessed.isEmpty()) {
+        return true;
+    }
+
+    QMap<QString, QString> values = m_pending;
+    QSet<QString> accessed = m_accessed;
+
+    m_flushing = values;
+    m_pending.clear();
+    m_accessed.clear();
+
+    locker.unlock();
+
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    bool written = m_repository->write(values, now + (qint64) m_ttl * 1000, accessed, now);
+
+    // Entries which could not be written are dropped rather than retried
+    // forever; the cache is only an optimization.
+    locker.relock();
+    m_flushing.clear();
+
+    return written;
+}
@@ -0,0 +1,85 @@
+#ifndef BIDSTACK_GIANTSWARM_SQLITECACHEADAPTER_HPP
+#define BIDSTACK_GIANTSWARM_SQLITECACHEADAPTER_HPP
+
+#include <QElapsedTimer>
+#include <QMap>
+#include <QMutex>
+#include <QSet>
+#include <QSqlDatabase>
+#include <QString>
+
+#include "concurrentcacheadapter.hpp"
+#include "../repositories/cacherepository.hpp"
+
+namespace Bidstack {
+    namespace Giantswarm {
+
+        namespace Caches {
+
+            const int DEFAULT_SQLITE_CACHE_TTL = 86400;
+            const int DEFAULT_SQLITE_CACHE_BATCH_SIZE = 32;
+            const int DEFAULT_SQLITE_CACHE_FLUSH_INTERVAL = 1000;
+
+            /**
+             * Persistent cache adapter storing entries in the given SQLite
+             * database through a CacheRepository, so that a restarted
+             * process starts with a warm cache.
+             *
+             * Stores and access times are buffered in memory and written in
+             * one transaction once batchSize of them have accumulated, the
+             * oldest is older than the flush interval, or flush() is called.
+             * Both are only checked by store(), never by reads, so a
+             * buffer left behind by the last store of a burst stays in
+             * memory until flush() or the destructor writes it; call
+             * flush() from a timer to bound that. The transaction runs
+             * without blocking the cache, and buffered values, including
+             * those being written, are visible to reads right away. Entries
+             * expire after ttl seconds regardless of the client's cache
+             * policies, and the least recently used ones are evicted once
+             * the cache outgrows its maximum size.
+             */
+            class SqliteCacheAdapter : public ConcurrentCacheAdapter {
+            public:
+                SqliteCacheAdapter(QSqlDatabase& database);
+                ~SqliteCacheAdapter();
+
+            public:
+                bool has(QString key);
+                QString fetch(QString key);
+                void store(QString key, QString value);
+                bool lookup(QString key, QString *value);
+
+                bool flush();
+                bool clear();
+
+                void setTtl(int seconds);
+                void setMaxSize(qint64 bytes);
+                void setBatchSize(int count);
+                void setFlushInterval(int msecs);
+
+            private:
+                void touch(QString key);
+                void flushIfDue(QMutexLocker& locker);
+                bool writePending();
+
+            private:
+                Repositories::CacheRepository *m_repository;
+
+                int m_ttl;
+                int m_batchSize;
+                int m_flushInterval;
+
+                QMutex m_flushMutex;
+                QMutex m_mutex;
+                QMap<QString, QString> m_pending;
+                QMap<QString, QString> m_flushing;
+                QSet<QString> m_accessed;
+                QElapsedTimer m_pendingSince;
+            };
+
+        };
+
+    };
+};
+
+#endif
@@ -0,0 +1,204 @@
+#include <QDateTime>
+#include <QMutexLocker>
+#include <QThreadPool>
+
+#include "tieredcacheadapter.hpp"
+#include "lockingcacheadapter.hpp"
+
+using namespace Bidstack::Cache;
+using namespace Bidstack::Giantswarm::Caches;
+
+TieredCacheAdapter::Statistics::Statistics() {
+    l1Hits = 0;
+    l2Hits = 0;
+    misses = 0;
+    l1Expired = 0;
+    l2Expired = 0;
+}
+
+TieredCacheAdapter::WriteBehindTask::WriteBehindTask(TieredCacheAdapter *adapter) {
+    m_adapter = adapter;
+}
+
+void TieredCacheAdapter::WriteBehindTask::run() {
+    m_adapter->drain();
+}
+
+TieredCacheAdapter::TieredCacheAdapter(AbstractCacheAdapter *l1, AbstractCacheAdapter *l2, WriteMode mode) {
+    m_l1 = concurrent(l1, &m_l1Wrapper);
+    m_l2 = concurrent(l2, &m_l2Wrapper);
+    m_mode = mode;
+    m_l1Ttl = 0;
+    m_l2Ttl = 0;
+    m_draining = false;
+}
+
+TieredCacheAdapter::~TieredCacheAdapter() {
+    flush();
+
+    delete m_l1Wrapper;
+    delete m_l2Wrapper;
+}
+
+bool TieredCacheAdapter::has(QString key) {
+    QString value;
+    return lookup(key, &value);
+}
+
+QString TieredCacheAdapter::fetch(QString key) {
+    QString value;
+    lookup(key, &value);
+    return value;
+}
+
+void TieredCacheAdapter::store(QString key, QString value) {
+    QString envelope = wrap(value);
+    m_l1->store(key, envelope);
+
+    if (m_mode == WriteThrough) {
+        m_l2->store(key, envelope);
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_queue.insert(key, envelope);
+
+    if (!m_draining) {
+        m_draining = true;
+        QThreadPool::globalInstance()->start(new WriteBehindTask(this));
+    }
+}
+
+bool TieredCacheAdapter::lookup(QString key, QString *value) {
+    QString envelope;
+
+    if (m_l1->lookup(key, &envelope)) {
+        if (unwrap(envelope, m_l1Ttl, value)) {
+            QMutexLocker locker(&m_mutex);
+            ++m_statistics.l1Hits;
+            return true;
+        }
+
+        QMutexLocker locker(&m_mutex);
+        ++m_statistics.l1Expired;
+    }
+
+    // Entries still waiting to be written behind are newer than L2's.
+    QMutexLocker locker(&m_mutex);
+    QMap<QString, QString>::const_iterator queued = m_queue.constFind(key);
+    bool found = queued != m_queue.constEnd();
+    if (found) {
+        envelope = queued.value();
+    }
+    locker.unlock();
+
+    if (!found && !m_l2->lookup(key, &envelope)) {
+        locker.relock();
+        ++m_statistics.misses;
+        return false;
+    }
+
+    if (!unwrap(envelope, m_l2Ttl, value)) {
+        locker.relock();
+        ++m_statistics.l2Expired;
+        ++m_statistics.misses;
+        return false;
+    }
+
+    // The entry starts a new L1 lifetime when promoted.
+    m_l1->store(key, wrap(*value));
+
+    locker.relock();
+    ++m_statistics.l2Hits;
+    return true;
+}
+
+void TieredCacheAdapter::setL1Ttl(int seconds) {
+    m_l1Ttl = qMax(0, seconds);
+}
+
+void TieredCacheAdapter::setL2Ttl(int seconds) {
+    m_l2Ttl = qMax(0, seconds);
+}
+
+/**
+ * Blocks until all stores waiting to be written behind have reached L2.
+ */
+void TieredCacheAdapter::flush() {
+    QMutexLocker locker(&m_mutex);
+    while (m_draining) {
+        m_drained.wait(&m_mutex);
+    }
+}
+
+TieredCacheAdapter::Statistics TieredCacheAdapter::statistics() const {
+    QMutexLocker locker(&m_mutex);
+    return m_statistics;
+}
+
+ConcurrentCacheAdapter* TieredCacheAdapter::concurrent(AbstractCacheAdapter *adapter, LockingCacheAdapter **wrapper) {
+    *wrapper = 0;
+
+    ConcurrentCacheAdapter *result = dynamic_cast<ConcurrentCacheAdapter*>(adapter);
+    if (!result) {
+        *wrapper = new LockingCacheAdapter(adapter);
+        result = *wrapper;
+    }
+
+    return result;
+}
+
+QString TieredCacheAdapter::wrap(const QString& value) {
+    return QString::number(QDateTime::currentMSecsSinceEpoch()) + ":" + value;
+}
+
+bool TieredCacheAdapter::unwrap(const QString& envelope, int ttl, QString *value) {
+    int separator = envelope.indexOf(':');
+    if (separator <= 0) {
+        return false;
+    }
+
+    bool ok = false;
+    qint64 storedAt = envelope.left(separator).toLongLong(&ok);
+    if (!ok) {
+        return false;
+    }
+
+    if (ttl > 0 && QDateTime::currentMSecsSinceEpoch() - storedAt >= (qint64) ttl * 1000) {
+        return false;
+    }
+
+    *value = envelope.mid(separator + 1);
+    return true;
+}
+
+/**
+ * Runs on a pool thread and writes queued stores to L2 until the queue
+ * stays empty.
+ */
+void TieredCacheAdapter::drain() {
+    QMutexLocker locker(&m_mutex);
+
+    while (!m_queue.isEmpty()) {
+        QMap<QString, QString> queue = m_queue;
+        locker.unlock();
+
+        QMap<QString, QString>::const_iterator it;
+        for (it = queue.constBegin(); it != queue.constEnd(); ++it) {
+            m_l2->store(it.key(), it.value());
+        }
+
+        locker.relock();
+
+        // Entries stay queued until written, so that lookups keep finding
+        // them; ones stored again in the meantime are written next round.
+        for (it = queue.constBegin(); it != queue.constEnd(); ++it) {
+            if (m_queue.value(it.key()) == it.value()) {
+                m_queue.remove(it.key());
+            }
+        }
+    }
+
+    m_draining = false;
+    m_drained.wakeAll();
+}
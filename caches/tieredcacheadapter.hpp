@@ -0,0 +1,105 @@
+#ifndef BIDSTACK_GIANTSWARM_TIEREDCACHEADAPTER_HPP
+#define BIDSTACK_GIANTSWARM_TIEREDCACHEADAPTER_HPP
+
+#include <QMap>
+#include <QMutex>
+#include <QRunnable>
+#include <QString>
+#include <QWaitCondition>
+
+#include "concurrentcacheadapter.hpp"
+
+namespace Bidstack {
+    namespace Giantswarm {
+
+        namespace Caches {
+
+            class LockingCacheAdapter;
+
+            /**
+             * Layers a fast cache (L1), e.g. a MemoryCacheAdapter, over a
+             * persistent one (L2), e.g. a SqliteCacheAdapter.
+             *
+             * Reads try L1 first; entries found in L2 only are copied into
+             * L1. Stores go to L1 right away and to L2 either in the same
+             * call (WriteThrough) or shortly after on a pool thread
+             * (WriteBehind). Each tier has its own TTL in seconds, 0 meaning
+             * no expiry; values are kept in both tiers with the time they
+             * were stored there as a prefix.
+             *
+             * Tiers which are not a ConcurrentCacheAdapter are wrapped in a
+             * LockingCacheAdapter. Neither tier is owned.
+             */
+            class TieredCacheAdapter : public ConcurrentCacheAdapter {
+            public:
+                enum WriteMode {
+                    WriteThrough = 0,
+                    WriteBehind = 1
+                };
+
+                struct Statistics {
+                    Statistics();
+
+                    qint64 l1Hits;
+                    qint64 l2Hits;
+                    qint64 misses;
+                    qint64 l1Expired;
+                    qint64 l2Expired;
+                };
+
+            public:
+                TieredCacheAdapter(Bidstack::Cache::AbstractCacheAdapter *l1, Bidstack::Cache::AbstractCacheAdapter *l2, WriteMode mode = WriteThrough);
+                ~TieredCacheAdapter();
+
+            public:
+                bool has(QString key);
+                QString fetch(QString key);
+                void store(QString key, QString value);
+                bool lookup(QString key, QString *value);
+
+                void setL1Ttl(int seconds);
+                void setL2Ttl(int seconds);
+                void flush();
+
+                Statistics statistics() const;
+
+            private:
+                class WriteBehindTask : public QRunnable {
+                public:
+                    WriteBehindTask(TieredCacheAdapter *adapter);
+                    void run();
+
+                private:
+                    TieredCacheAdapter *m_adapter;
+                };
+
+                static ConcurrentCacheAdapter* concurrent(Bidstack::Cache::AbstractCacheAdapter *adapter, LockingCacheAdapter **wrapper);
+                static QString wrap(const QString& value);
+                static bool unwrap(const QString& envelope, int ttl, QString *value);
+
+                void drain();
+
+            private:
+                ConcurrentCacheAdapter *m_l1;
+                ConcurrentCacheAdapter *m_l2;
+                LockingCacheAdapter *m_l1Wrapper;
+                LockingCacheAdapter *m_l2Wrapper;
+
+                WriteMode m_mode;
+                int m_l1Ttl;
+                int m_l2Ttl;
+
+                mutable QMutex m_mutex;
+                Statistics m_statistics;
+
+                QMap<QString, QString> m_queue;
+                bool m_draining;
+                QWaitCondition m_drained;
+            };
+
+        };
+
+    };
+};
+
+#endif
@@ -0,0 +1,180 @@
+#include <QMutexLocker>
+#include <QRunnable>
+
+#include "giantswarmbatch.hpp"
+#include "giantswarmclient.hpp"
+#include "giantswarmreply.hpp"
+#include "giantswarmtask.hpp"
+
+using namespace Bidstack::Giantswarm;
+
+class GiantswarmBatch::Runner : public QRunnable {
+public:
+    Runner(QSharedPointer<Run> run) {
+        m_run = run;
+    }
+
+    void run() {
+        GiantswarmBatch::work(m_run);
+    }
+
+private:
+    QSharedPointer<Run> m_run;
+};
+
+GiantswarmBatch::GiantswarmBatch(GiantswarmClient *client, int maxInFlight, QObject *parent) : QObject(parent) {
+    m_client = client;
+    m_maxInFlight = qMax(1, maxInFlight);
+    m_next = 0;
+    m_done = 0;
+    m_error = -1;
+}
+
+GiantswarmBatch::~GiantswarmBatch() {
+    // Outstanding replies belong to the batch; detach them so their results
+    // are simply dropped.
+    foreach (GiantswarmReply *reply, m_pending.keys()) {
+        disconnect(reply, 0, this, 0);
+        reply->deleteLater();
+    }
+}
+
+void GiantswarmBatch::add(GiantswarmEndpoint::Endpoint endpoint, const char *method, const char *returnType, QVariantList args) {
+    Call call;
+    call.endpoint = endpoint;
+    call.method = method;
+    call.returnType = returnType;
+    call.args = args;
+
+    m_calls.append(call);
+    m_results.append(QVariant());
+}
+
+void GiantswarmBatch::start() {
+    if (m_calls.isEmpty()) {
+        emit finished();
+        return;
+    }
+
+    while (m_pending.size() < m_maxInFlight && m_next < m_calls.size()) {
+        startNext();
+    }
+}
+
+/**
+ * Runs the calls on the client's pool and returns once all of them have
+ * finished, without processing events. The calling thread works through
+ * the calls as well, so at most maxInFlight - 1 pool threads are used and
+ * the batch completes even when called from a pool thread.
+ */
+void GiantswarmBatch::run() {
+    if (m_calls.isEmpty()) {
+        return;
+    }
+
+    QSharedPointer<Run> run(new Run());
+    run->client = m_client;
+    run->calls = m_calls;
+    run->results = m_results;
+    run->next = 0;
+    run->done = 0;
+    run->error = -1;
+
+    int helpers = qMin(m_maxInFlight, m_calls.size()) - 1;
+    for (int i = 0; i < helpers; ++i) {
+        m_client->startOnPool(new Runner(run), m_calls.first().endpoint);
+    }
+
+    work(run);
+
+    QMutexLocker locker(&run->mutex);
+    while (run->done < run->calls.size()) {
+        run->finished.wait(&run->mutex);
+    }
+
+    m_results = run->results;
+    m_error = run->error;
+    m_next = m_calls.size();
+    m_done = m_calls.size();
+}
+
+bool GiantswarmBatch::isFinished() const {
+    return m_done == m_calls.size();
+}
+
+int GiantswarmBatch::size() const {
+    return m_calls.size();
+}
+
+QVariantList GiantswarmBatch::results() const {
+    return m_results;
+}
+
+int GiantswarmBatch::error() const {
+    return m_error;
+}
+
+void GiantswarmBatch::replyFinished() {
+    GiantswarmReply *reply = qobject_cast<GiantswarmReply*>(sender());
+    if (!reply || !m_pending.contains(reply)) {
+        return;
+    }
+
+    int index = m_pending.take(reply);
+    m_results[index] = reply->hasError() ? QVariant() : reply->result();
+
+    if (reply->hasError() && m_error < 0) {
+        m_error = reply->error();
+    }
+
+    reply->deleteLater();
+    ++m_done;
+
+    if (m_next < m_calls.size()) {
+        startNext();
+    } else if (isFinished()) {
+        emit finished();
+    }
+}
+
+void GiantswarmBatch::startNext() {
+    const Call& call = m_calls.at(m_next);
+
+    GiantswarmReply *reply = m_client->invokeAsync(
+        call.endpoint,
+        call.method.constData(),
+        call.returnType.constData(),
+        call.args
+    );
+
+    connect(reply, SIGNAL(finished()), this, SLOT(replyFinished()));
+    m_pending.insert(reply, m_next);
+    ++m_next;
+}
+
+/**
+ * Takes calls off the run until none are left.
+ */
+void GiantswarmBatch::work(QSharedPointer<Run> run) {
+    QMutexLocker locker(&run->mutex);
+
+    while (run->next < run->calls.size()) {
+        int index = run->next++;
+        Call call = run->calls.at(index);
+        locker.unlock();
+
+        QVariant result;
+        int error = GiantswarmTask::invoke(run->client, call.method.constData(), call.returnType.constData(), call.args, &result);
+
+        locker.relock();
+        run->results[index] = error >= 0 ? QVariant() : result;
+
+        if (error >= 0 && run->error < 0) {
+            run->error = error;
+        }
+
+        if (++run->done == run->calls.size()) {
+            run->finished.wakeAll();
+        }
+    }
+}
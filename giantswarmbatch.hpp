@@ -0,0 +1,99 @@
+#ifndef BIDSTACK_GIANTSWARM_BATCH_HPP
+#define BIDSTACK_GIANTSWARM_BATCH_HPP
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QSharedPointer>
+#include <QVariant>
+#include <QVariantList>
+#include <QWaitCondition>
+
+#include "giantswarmendpoint.hpp"
+
+namespace Bidstack {
+    namespace Giantswarm {
+
+        class GiantswarmClient;
+        class GiantswarmReply;
+
+        /**
+         * Runs a list of asynchronous client calls with at most maxInFlight
+         * of them outstanding at any time. Results are kept in the order the
+         * calls were added, regardless of the order they complete in; a
+         * call that ended with an error leaves an invalid result.
+         *
+         * start() reports through finished() and needs an event loop in
+         * the calling thread; run() blocks instead and needs none.
+         */
+        class GiantswarmBatch : public QObject {
+            Q_OBJECT
+
+        public:
+            GiantswarmBatch(GiantswarmClient *client, int maxInFlight, QObject *parent = 0);
+            ~GiantswarmBatch();
+
+        public:
+            void add(GiantswarmEndpoint::Endpoint endpoint, const char *method, const char *returnType, QVariantList args);
+            void start();
+            void run();
+
+            bool isFinished() const;
+            int size() const;
+            QVariantList results() const;
+            int error() const;
+
+        signals:
+            void finished();
+
+        private slots:
+            void replyFinished();
+
+        private:
+            void startNext();
+
+        private:
+            struct Call {
+                GiantswarmEndpoint::Endpoint endpoint;
+                QByteArray method;
+                QByteArray returnType;
+                QVariantList args;
+            };
+
+            /**
+             * State of run(), shared with the pool threads helping out so
+             * that it outlives the batch if one of them starts late.
+             */
+            struct Run {
+                GiantswarmClient *client;
+                QList<Call> calls;
+                QVariantList results;
+                int next;
+                int done;
+                int error;
+
+                QMutex mutex;
+                QWaitCondition finished;
+            };
+
+            class Runner;
+
+            static void work(QSharedPointer<Run> run);
+
+            GiantswarmClient *m_client;
+            int m_maxInFlight;
+            int m_next;
+            int m_done;
+            int m_error;
+
+            QList<Call> m_calls;
+            QVariantList m_results;
+            QHash<GiantswarmReply*, int> m_pending;
+        };
+
+    };
+};
+
+#endif
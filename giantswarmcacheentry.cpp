@@ -0,0 +1,219 @@
+#include <QDataStream>
+#include <QDateTime>
+#include <QIODevice>
+
+#include "giantswarmcacheentry.hpp"
+
+#include "deps/qjson4/QJsonArray.h"
+#include "deps/qjson4/QJsonDocument.h"
+#include "deps/qjson4/QJsonObject.h"
+#include "deps/qjson4/QJsonParseError.h"
+
+using namespace Bidstack::Giantswarm;
+
+GiantswarmCacheEntry::GiantswarmCacheEntry() {
+    m_status = 0;
+    m_storedAt = 0;
+}
+
+GiantswarmCacheEntry::GiantswarmCacheEntry(int status, QMap<QString, QString> headers, QByteArray body) {
+    m_status = status;
+    m_headers = headers;
+    m_body = body;
+    m_storedAt = QDateTime::currentMSecsSinceEpoch();
+}
+
+GiantswarmCacheEntry::GiantswarmCacheEntry(const GiantswarmResponse& response) {
+    m_status = response.status();
+    m_headers = response.headers();
+    m_body = response.body();
+    m_storedAt = QDateTime::currentMSecsSinceEpoch();
+}
+
+bool GiantswarmCacheEntry::isLegacyString(const QString& string) {
+    return !string.isEmpty() && string.at(0) != QLatin1Char(CACHE_ENTRY_MAGIC);
+}
+
+bool GiantswarmCacheEntry::fromCachableString(const QString& string) {
+    if (isLegacyString(string)) {
+        return fromLegacyString(string);
+    }
+
+    QByteArray bytes = string.toLatin1();
+    if (bytes.size() < 2 || bytes.at(1) < 1 || bytes.at(1) > CACHE_ENTRY_VERSION) {
+        return false;
+    }
+
+    QDataStream in(bytes);
+    in.setVersion(QDataStream::Qt_4_6);
+    in.skipRawData(2);
+
+    qint64 storedAt = 0;
+    if (bytes.at(1) >= 2) {
+        in >> storedAt;
+    }
+
+    qint32 status;
+    qint32 length;
+    QMap<QString, QString> headers;
+    in >> status >> headers >> length;
+
+    qint64 offset = in.device()->pos();
+    if (in.status() != QDataStream::Ok || length < 0 || offset + length > bytes.size()) {
+        return false;
+    }
+
+    m_storedAt = storedAt;
+    m_status = status;
+    m_headers = headers;
+    m_body = bytes.mid(offset, length);
+
+    return true;
+}
+
+QString GiantswarmCacheEntry::toCachableString() const {
+    QByteArray bytes;
+    bytes.reserve(m_body.size() + 256);
+
+    QDataStream out(&bytes, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_4_6);
+    out.writeRawData(&CACHE_ENTRY_MAGIC, 1);
+    out.writeRawData(&CACHE_ENTRY_VERSION, 1);
+    out << m_storedAt << (qint32) m_status << m_headers << (qint32) m_body.size();
+    out.writeRawData(m_body.constData(), m_body.size());
+
+    return QString::fromLatin1(bytes.constData(), bytes.size());
+}
+
+GiantswarmResponse GiantswarmCacheEntry::toResponse(GiantswarmResponse::ParseMode mode) const {
+    return GiantswarmResponse(m_status, m_headers, m_body, mode);
+}
+
+int GiantswarmCacheEntry::status() const {
+    return m_status;
+}
+
+QMap<QString, QString> GiantswarmCacheEntry::headers() const {
+    return m_headers;
+}
+
+QByteArray GiantswarmCacheEntry::body() const {
+    return m_body;
+}
+
+qint64 GiantswarmCacheEntry::storedAt() const {
+    return m_storedAt;
+}
+
+/**
+ * Milliseconds since the entry was stored, or -1 if that is unknown.
+ */
+qint64 GiantswarmCacheEntry::age() const {
+    if (m_storedAt <= 0) {
+        return -1;
+    }
+
+    return qMax((qint64) 0, QDateTime::currentMSecsSinceEpoch() - m_storedAt);
+}
+
+/**
+ * Returns the value of the given header, ignoring the case of its name.
+ */
+QString GiantswarmCacheEntry::header(const QString& name) const {
+    QMap<QString, QString>::const_iterator it;
+    for (it = m_headers.constBegin(); it != m_headers.constEnd(); ++it) {
+        if (it.key().compare(name, Qt::CaseInsensitive) == 0) {
+            return it.value();
+        }
+    }
+
+    return QString();
+}
+
+/**
+ * Returns the conditional request headers matching the entry's
+ * validators; empty if the response carried none.
+ */
+QMap<QString, QString> GiantswarmCacheEntry::validators() const {
+    QMap<QString, QString> validators;
+
+    QString etag = header("ETag");
+    if (!etag.isEmpty()) {
+        validators["If-None-Match"] = etag;
+    }
+
+    QString lastModified = header("Last-Modified");
+    if (!lastModified.isEmpty()) {
+        validators["If-Modified-Since"] = lastModified;
+    }
+
+    return validators;
+}
+
+/**
+ * Marks the entry as fresh again after a 304 Not Modified, taking over
+ * the headers sent with it, e.g. a new ETag.
+ */
+void GiantswarmCacheEntry::refresh(QMap<QString, QString> headers) {
+    QMap<QString, QString>::const_iterator it;
+    for (it = headers.constBegin(); it != headers.constEnd(); ++it) {
+        // The stored body keeps its own length.
+        if (it.key().compare("Content-Length", Qt::CaseInsensitive) == 0) {
+            continue;
+        }
+
+        QMap<QString, QString>::iterator existing;
+        for (existing = m_headers.begin(); existing != m_headers.end(); ++existing) {
+            if (existing.key().compare(it.key(), Qt::CaseInsensitive) == 0) {
+                break;
+            }
+        }
+
+        if (existing != m_headers.end()) {
+            existing.value() = it.value();
+        } else {
+            m_headers.insert(it.key(), it.value());
+        }
+    }
+
+    m_storedAt = QDateTime::currentMSecsSinceEpoch();
+}
+
+/**
+ * Example:
+ *
+ *   {
+ *     "status": 200,
+ *     "headers": [ { "name": "Content-Type", "value": "application/json" } ],
+ *     "body": "{\"result\":\"success\"}"
+ *   }
+ *
+ */
+bool GiantswarmCacheEntry::fromLegacyString(const QString& string) {
+    QJsonParseError err;
+    QJsonDocument doc = QJsonDocument::fromJson(string.toUtf8(), &err);
+
+    if (doc.isNull()) {
+        return false;
+    }
+
+    QJsonObject object = doc.object();
+    QJsonArray headers = object.take("headers").toArray();
+
+    m_headers.clear();
+    for (int i = 0; i < headers.size(); ++i) {
+        QJsonObject header = headers.at(i).toObject();
+        QString name = header.take("name").toString();
+
+        // Older writers stored malformed header entries; skip those.
+        if (!name.isEmpty()) {
+            m_headers[name] = header.take("value").toString();
+        }
+    }
+
+    m_storedAt = 0;
+    m_status = object.take("status").toInt();
+    m_body = object.take("body").toString().toUtf8();
+
+    return true;
+}
@@ -0,0 +1,69 @@
+#ifndef BIDSTACK_GIANTSWARM_CACHEENTRY_HPP
+#define BIDSTACK_GIANTSWARM_CACHEENTRY_HPP
+
+#include <QByteArray>
+#include <QMap>
+#include <QString>
+
+#include "giantswarmresponse.hpp"
+
+namespace Bidstack {
+    namespace Giantswarm {
+
+        const char CACHE_ENTRY_MAGIC = '\xB5';
+        const char CACHE_ENTRY_VERSION = 2;
+
+        /**
+         * A cached API response.
+         *
+         * Entries are written as a magic byte and a version byte followed by
+         * a QDataStream encoded header (time of storage, status, headers, body
+         * length) and the raw body bytes. The bytes are mapped one-to-one onto the Latin-1
+         * range of a QString, as that is what AbstractCacheAdapter stores.
+         *
+         * Entries written by older versions, either as version 1 without a
+         * storage time or as a JSON document with an escaped body, are still
+         * understood when read; their age is unknown.
+         *
+         * The ETag and Last-Modified headers of the stored response are
+         * used as validators when the entry is revalidated.
+         */
+        class GiantswarmCacheEntry {
+        public:
+            GiantswarmCacheEntry();
+            GiantswarmCacheEntry(int status, QMap<QString, QString> headers, QByteArray body);
+            GiantswarmCacheEntry(const GiantswarmResponse& response);
+
+        public:
+            static bool isLegacyString(const QString& string);
+
+            bool fromCachableString(const QString& string);
+            QString toCachableString() const;
+
+            GiantswarmResponse toResponse(GiantswarmResponse::ParseMode mode = GiantswarmResponse::ParseDocument) const;
+
+            int status() const;
+            QMap<QString, QString> headers() const;
+            QByteArray body() const;
+
+            qint64 storedAt() const;
+            qint64 age() const;
+
+            QString header(const QString& name) const;
+            QMap<QString, QString> validators() const;
+            void refresh(QMap<QString, QString> headers);
+
+        private:
+            bool fromLegacyString(const QString& string);
+
+        private:
+            int m_status;
+            QMap<QString, QString> m_headers;
+            QByteArray m_body;
+            qint64 m_storedAt;
+        };
+
+    };
+};
+
+#endif
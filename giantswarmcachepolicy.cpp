@@ -0,0 +1,51 @@
+#include "giantswarmcachepolicy.hpp"
+
+using namespace Bidstack::Giantswarm;
+
+GiantswarmCachePolicy::GiantswarmCachePolicy() {
+    m_ttl = 0;
+    m_staleWhileRevalidate = 0;
+    m_maxAge = 0;
+}
+
+GiantswarmCachePolicy::GiantswarmCachePolicy(int ttl, int staleWhileRevalidate, int maxAge) {
+    m_ttl = qMax(0, ttl);
+    m_staleWhileRevalidate = qMax(0, staleWhileRevalidate);
+    m_maxAge = qMax(0, maxAge);
+}
+
+int GiantswarmCachePolicy::ttl() const {
+    return m_ttl;
+}
+
+int GiantswarmCachePolicy::staleWhileRevalidate() const {
+    return m_staleWhileRevalidate;
+}
+
+int GiantswarmCachePolicy::maxAge() const {
+    return m_maxAge;
+}
+
+bool GiantswarmCachePolicy::isCachable() const {
+    return m_ttl > 0;
+}
+
+GiantswarmCachePolicy::Freshness GiantswarmCachePolicy::freshness(qint64 ageMs) const {
+    if (ageMs < 0 || !isCachable()) {
+        return Expired;
+    }
+
+    if (ageMs < (qint64) m_ttl * 1000) {
+        return Fresh;
+    }
+
+    if (ageMs < (qint64) (m_ttl + m_staleWhileRevalidate) * 1000) {
+        return Stale;
+    }
+
+    return Expired;
+}
+
+bool GiantswarmCachePolicy::isUsableOnError(qint64 ageMs) const {
+    return ageMs >= 0 && ageMs < (qint64) m_maxAge * 1000;
+}
@@ -0,0 +1,50 @@
+#ifndef BIDSTACK_GIANTSWARM_CACHEPOLICY_HPP
+#define BIDSTACK_GIANTSWARM_CACHEPOLICY_HPP
+
+#include <QtGlobal>
+
+namespace Bidstack {
+    namespace Giantswarm {
+
+        /**
+         * Freshness rules for cached responses of one endpoint, in seconds.
+         *
+         *  - ttl: entries younger than this are served without a request.
+         *    A ttl of 0 disables caching for the endpoint.
+         *  - staleWhileRevalidate: for this long after the ttl has passed
+         *    the entry is still served while it is refreshed in the
+         *    background.
+         *  - maxAge: entries younger than this are served when refreshing
+         *    them fails. 0 means stale entries are never served on errors.
+         */
+        class GiantswarmCachePolicy {
+        public:
+            enum Freshness {
+                Fresh = 0,
+                Stale = 1,
+                Expired = 2
+            };
+
+        public:
+            GiantswarmCachePolicy();
+            GiantswarmCachePolicy(int ttl, int staleWhileRevalidate = 0, int maxAge = 0);
+
+        public:
+            int ttl() const;
+            int staleWhileRevalidate() const;
+            int maxAge() const;
+
+            bool isCachable() const;
+            Freshness freshness(qint64 ageMs) const;
+            bool isUsableOnError(qint64 ageMs) const;
+
+        private:
+            int m_ttl;
+            int m_staleWhileRevalidate;
+            int m_maxAge;
+        };
+
+    };
+};
+
+#endif
@@ -1,26 +1,147 @@
+#include <QCryptographicHash>
 #include <QDebug>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QString>
+#include <QUrl>
+#include <QUuid>
+#include <QWaitCondition>
 
 #include "giantswarmclient.hpp"
+#include "giantswarmcacheentry.hpp"
+#include "giantswarmjsonreader.hpp"
+#include "giantswarmtask.hpp"
+
+#include "jobs/allapplicationsjob.hpp"
+#include "jobs/applicationstatisticsjob.hpp"
 
 #include "deps/cache/devnullcacheadapter.hpp"
 
 #include "deps/qjson4/QJsonDocument.h"
 #include "deps/qjson4/QJsonObject.h"
 #include "deps/qjson4/QJsonArray.h"
-#include "deps/qjson4/QJsonParseError.h"
 
 using namespace Bidstack::Http;
 using namespace Bidstack::Cache;
 using namespace Bidstack::Giantswarm;
+using namespace Bidstack::Giantswarm::Jobs;
 using namespace Bidstack::Giantswarm::Repositories;
 
+namespace {
+
+    /**
+     * Decodes the data of a Streamed response into one of the typed
+     * results.
+     */
+    template <typename T>
+    class TypedDataReader : public GiantswarmResponse::DataReader {
+    public:
+        TypedDataReader(T *value) {
+            m_value = value;
+        }
+
+        bool read(GiantswarmJsonReader& reader) {
+            return T::read(reader, m_value);
+        }
+
+    private:
+        T *m_value;
+    };
+
+    class ApplicationsDataReader : public GiantswarmResponse::DataReader {
+    public:
+        ApplicationsDataReader(QVariantList *applications) {
+            m_applications = applications;
+        }
+
+        bool read(GiantswarmJsonReader& reader) {
+            if (reader.token() != GiantswarmJsonReader::BeginArray) {
+                return reader.skip();
+            }
+
+            while (reader.next() == GiantswarmJsonReader::BeginObject) {
+                QVariantMap application;
+                application["company"] = "";
+                application["environment"] = "";
+                application["application"] = "";
+                application["created_at"] = "";
+
+                while (reader.next() == GiantswarmJsonReader::Name) {
+                    QString key = reader.string();
+                    reader.next();
+
+                    if (key == "company") {
+                        application["company"] = reader.stringValue();
+                    } else if (key == "env") {
+                        application["environment"] = reader.stringValue();
+                    } else if (key == "app") {
+                        application["application"] = reader.stringValue();
+                    } else if (key == "created") {
+                        application["created_at"] = reader.stringValue();
+                    } else {
+                        reader.skip();
+                    }
+                }
+
+                m_applications->append(application);
+            }
+
+            return reader.token() == GiantswarmJsonReader::EndArray;
+        }
+
+    private:
+        QVariantList *m_applications;
+    };
+
+};
+
 GiantswarmClient::GiantswarmClient(QSqlDatabase& database, QObject *parent) : QObject(parent) {
     m_endpoint = "https://api.giantswarm.io/v1";
-    m_httpclient = new HttpClient();
-    m_cache = new DevNullCacheAdapter();
-    m_environments = new EnvironmentRepository(database);
+    m_connections = new GiantswarmConnectionPool();
+    m_governor = new GiantswarmGovernor();
+    m_metrics = new GiantswarmMetrics();
+    m_defaultCache = new DevNullCacheAdapter();
+    m_lockingCache = 0;
+    m_cache = 0;
+    setCache(m_defaultCache);
+    m_environments = new EnvironmentRepository(database, this);
     m_token = "";
+
+    m_pool = new QThreadPool(this);
+    m_pool->setMaxThreadCount(DEFAULT_MAX_CONCURRENT_REQUESTS);
+    m_pool->setExpiryTimeout(DEFAULT_CONNECTION_IDLE_TIMEOUT * 1000);
+    m_maxFanOut = DEFAULT_MAX_FAN_OUT;
+
+    // Only reads are retried by default; mutations fail on the first error
+    // unless retries are enabled for them explicitly.
+    m_retryPolicies.resize(GiantswarmEndpoint::IdempotencyCount);
+    m_retryPolicies[GiantswarmEndpoint::Safe] = GiantswarmRetryPolicy(3, 100, 2000);
+
+    m_cachePolicies.resize(GiantswarmEndpoint::Count);
+    m_cachePolicies[GiantswarmEndpoint::Companies] = GiantswarmCachePolicy(60, 60, 3600);
+    m_cachePolicies[GiantswarmEndpoint::CompanyUsers] = GiantswarmCachePolicy(60, 60, 3600);
+    m_cachePolicies[GiantswarmEndpoint::Applications] = GiantswarmCachePolicy(30, 30, 600);
+    m_cachePolicies[GiantswarmEndpoint::ApplicationStatus] = GiantswarmCachePolicy(5, 5, 60);
+    m_cachePolicies[GiantswarmEndpoint::InstanceStatistics] = GiantswarmCachePolicy(5, 5, 60);
+    m_cachePolicies[GiantswarmEndpoint::User] = GiantswarmCachePolicy(300, 300, 86400);
+
+    // Registered under the names the invokable methods declare, which is
+    // how tasks look up their return types.
+    qRegisterMetaType<ApplicationStatus>("ApplicationStatus");
+    qRegisterMetaType<InstanceStatistics>("InstanceStatistics");
+}
+
+GiantswarmClient::~GiantswarmClient() {
+    // Pool threads own their connections and call back into this client,
+    // so they have to be gone before anything else is torn down.
+    delete m_pool;
+    m_pool = 0;
+
+    delete m_connections;
+    delete m_governor;
+    delete m_metrics;
+    delete m_lockingCache;
+    delete m_defaultCache;
 }
 
 /**
@@ -28,9 +149,89 @@ GiantswarmClient::GiantswarmClient(QSqlDatabase& database, QObject *parent) : QO
  */
 
 void GiantswarmClient::setEndpoint(QString endpoint) {
+    QWriteLocker locker(&m_settingsLock);
     m_endpoint = endpoint;
 }
 
+void GiantswarmClient::setMaxConcurrentRequests(int count) {
+    m_pool->setMaxThreadCount(qMax(1, count));
+}
+
+void GiantswarmClient::setMaxFanOut(int count) {
+    QWriteLocker locker(&m_settingsLock);
+    m_maxFanOut = qMax(1, count);
+}
+
+void GiantswarmClient::setMaxConcurrentRequestsPerHost(int count) {
+    m_connections->setMaxConcurrentRequestsPerHost(count);
+}
+
+/**
+ * Connections unused for longer than this are re-established before
+ * reuse. Idle pool threads, and with them their connections, expire after
+ * the same time. 0 means neither expire.
+ */
+void GiantswarmClient::setConnectionIdleTimeout(int seconds) {
+    m_connections->setIdleTimeout(seconds);
+    m_pool->setExpiryTimeout(seconds > 0 ? seconds * 1000 : -1);
+}
+
+/**
+ * Used for connections established from now on, e.g. to trust a private
+ * CA. Session resumption is always enabled.
+ */
+void GiantswarmClient::setSslConfiguration(const QSslConfiguration& configuration) {
+    m_connections->setSslConfiguration(configuration);
+}
+
+void GiantswarmClient::setStorageProfile(const GiantswarmStorageProfile& profile) {
+    m_environments->setStorageProfile(profile);
+}
+
+/**
+ * Rate limits apply to the client as a whole, to each company and to each
+ * endpoint category; a request has to satisfy all limits that apply to it.
+ * Nothing is limited by default.
+ */
+void GiantswarmClient::setRateLimit(const GiantswarmRateLimit& limit) {
+    m_governor->setGlobalLimit(limit);
+}
+
+void GiantswarmClient::setCompanyRateLimit(const GiantswarmRateLimit& limit) {
+    m_governor->setCompanyLimit(limit);
+}
+
+void GiantswarmClient::setCompanyRateLimit(QString companyName, const GiantswarmRateLimit& limit) {
+    m_governor->setCompanyLimit(companyName, limit);
+}
+
+void GiantswarmClient::setCategoryRateLimit(GiantswarmEndpoint::Category category, const GiantswarmRateLimit& limit) {
+    m_governor->setCategoryLimit(category, limit);
+}
+
+void GiantswarmClient::setPriority(GiantswarmEndpoint::Category category, GiantswarmGovernor::Priority priority) {
+    m_governor->setPriority(category, priority);
+}
+
+/**
+ * Server errors and 429 Too Many Requests are retried according to the
+ * policy of the endpoint's idempotency class, as long as the retry
+ * budget allows.
+ */
+void GiantswarmClient::setRetryPolicy(GiantswarmEndpoint::Idempotency idempotency, GiantswarmRetryPolicy policy) {
+    QWriteLocker locker(&m_settingsLock);
+    m_retryPolicies[idempotency] = policy;
+}
+
+GiantswarmRetryPolicy GiantswarmClient::retryPolicy(GiantswarmEndpoint::Idempotency idempotency) const {
+    QReadLocker locker(&m_settingsLock);
+    return m_retryPolicies.at(idempotency);
+}
+
+void GiantswarmClient::setRetryBudget(double ratio, int maxTokens) {
+    m_retryBudget.configure(ratio, maxTokens);
+}
+
 /**
  * Authentication
  */
@@ -44,14 +245,14 @@ bool GiantswarmClient::login(QString email, QString password) {
     QJsonDocument doc;
     doc.setObject(object);
 
-    HttpRequest *request = new HttpRequest();
-    request->setMethod("POST");
-    request->setUrl(m_endpoint + "/user/" + email + "/login");
-    request->setBody(new HttpBody(doc.toJson()));
-    HttpResponse* response;
+    HttpRequest request;
+    request.setMethod("POST");
+    request.setUrl(endpoint() + "/user/" + email + "/login");
+    request.setBody(new HttpBody(doc.toJson()));
+    GiantswarmResponse response;
 
     try {
-        response = send(request);
+        response = send(GiantswarmEndpoint::Login, request);
         assertStatusCode(response, STATUS_CODE_SUCCESS);
     } catch (GiantswarmError& e) {
         qWarning() << "Error:" << e.errorString();
@@ -59,41 +260,51 @@ bool GiantswarmClient::login(QString email, QString password) {
     }
 
     QJsonObject data = extractDataAsObject(response);
-    m_token = data.take("Id").toString();
+    QString token = data.take("Id").toString();
 
-    if (m_token.isEmpty()) {
+    if (token.isEmpty()) {
         qWarning() << "Could not find token in response!";
         return false;
     }
 
+    setToken(token, email);
     return true;
 }
 
 bool GiantswarmClient::logout() {
     assertLoggedIn();
 
-    HttpRequest* request = new HttpRequest();
-    request->setMethod("POST");
-    request->setUrl(m_endpoint + "/token/logout");
+    HttpRequest request;
+    request.setMethod("POST");
+    request.setUrl(endpoint() + "/token/logout");
 
     try {
-        HttpResponse* response = send(request);
+        GiantswarmResponse response = send(GiantswarmEndpoint::Logout, request);
         assertStatusCode(response, STATUS_CODE_SUCCESS);
     } catch (GiantswarmError& e) {
         qWarning() << "Error:" << e.errorString();
         return false;
     }
 
-    m_token = "";
+    setToken("");
     return true;
 }
 
 bool GiantswarmClient::isLoggedIn() {
-    return !m_token.isEmpty();
+    return !token().isEmpty();
 }
 
-void GiantswarmClient::setToken(QString token) {
+/**
+ * The identity names the account the token belongs to, e.g. its email
+ * address. Cached responses are keyed by it, so they can be reused with
+ * another token of the same account, e.g. by the next run of a tool that
+ * logs in every time. Without an identity the token itself is used.
+ * Requests already in flight keep using the token they started with.
+ */
+void GiantswarmClient::setToken(QString token, QString identity) {
+    QWriteLocker locker(&m_settingsLock);
     m_token = token;
+    m_identity = identity.toLower();
 }
 
 /**
@@ -103,21 +314,22 @@ void GiantswarmClient::setToken(QString token) {
 QVariantList GiantswarmClient::getCompanies() {
     assertLoggedIn();
 
-    HttpRequest* request = new HttpRequest();
-    request->setMethod("GET");
-    request->setUrl(m_endpoint + "/user/me/memberships");
-    HttpResponse* response;
+    HttpRequest request;
+    request.setMethod("GET");
+    request.setUrl(endpoint() + "/user/me/memberships");
+    GiantswarmResponse response;
 
     QVariantList companies;
 
     try {
-        response = send("companies", request);
+        response = send(GiantswarmEndpoint::Companies, QStringList(), request);
         assertStatusCode(response, STATUS_CODE_SUCCESS);
     } catch (GiantswarmError& e) {
         qWarning() << "Error:" << e.errorString();
         return companies;
     }
 
+    GiantswarmMetrics::Timer timer(m_metrics, GiantswarmEndpoint::Companies, GiantswarmMetrics::Conversion);
     QJsonArray data = extractDataAsArray(response);
 
     for (int i = 0; i < data.size(); ++i) {
@@ -140,37 +352,39 @@ bool GiantswarmClient::createCompany(QString companyName) {
     QJsonDocument doc;
     doc.setObject(object);
 
-    HttpRequest* request = new HttpRequest();
-    request->setMethod("POST");
-    request->setUrl(m_endpoint + "/company");
-    request->setBody(new HttpBody(doc.toJson()));
+    HttpRequest request;
+    request.setMethod("POST");
+    request.setUrl(endpoint() + "/company");
+    request.setBody(new HttpBody(doc.toJson()));
 
     try {
-        HttpResponse* response = send(request);
+        GiantswarmResponse response = send(GiantswarmEndpoint::CreateCompany, request);
         assertStatusCode(response, STATUS_CODE_CREATED);
     } catch (GiantswarmError& e) {
         qWarning() << "Error:" << e.errorString();
         return false;
     }
 
+    invalidateCache(GiantswarmEndpoint::Companies);
     return true;
 }
 
 bool GiantswarmClient::deleteCompany(QString companyName) {
     assertLoggedIn();
 
-    HttpRequest* request = new HttpRequest();
-    request->setMethod("DELETE");
-    request->setUrl(m_endpoint + "/company/" + companyName);
+    HttpRequest request;
+    request.setMethod("DELETE");
+    request.setUrl(endpoint() + "/company/" + companyName);
 
     try {
-        HttpResponse* response = send(request);
+        GiantswarmResponse response = send(GiantswarmEndpoint::DeleteCompany, request);
         assertStatusCode(response, STATUS_CODE_DELETED);
     } catch (GiantswarmError& e) {
         qWarning() << "Error:" << e.errorString();
         return false;
     }
 
+    invalidateCache(GiantswarmEndpoint::Companies);
     return true;
 }
 
@@ -181,21 +395,22 @@ bool GiantswarmClient::deleteCompany(QString companyName) {
 QVariantList GiantswarmClient::getCompanyUsers(QString companyName) {
     assertLoggedIn();
 
-    HttpRequest* request = new HttpRequest();
-    request->setMethod("GET");
-    request->setUrl(m_endpoint + "/company/" + companyName);
-    HttpResponse* response;
+    HttpRequest request;
+    request.setMethod("GET");
+    request.setUrl(endpoint() + "/company/" + companyName);
+    GiantswarmResponse response;
 
     QVariantList users;
 
     try {
-        response = send("company_users", request);
+        response = send(GiantswarmEndpoint::CompanyUsers, QStringList() << companyName, request);
         assertStatusCode(response, STATUS_CODE_SUCCESS);
     } catch (GiantswarmError& e) {
         qWarning() << "Error:" << e.errorString();
         return users;
     }
 
+    GiantswarmMetrics::Timer timer(m_metrics, GiantswarmEndpoint::CompanyUsers, GiantswarmMetrics::Conversion);
     QJsonObject data = extractDataAsObject(response);
     QJsonArray members = data["members"].toArray();
 
@@ -215,19 +430,20 @@ bool GiantswarmClient::addUserToCompany(QString companyName, QString username) {
     QJsonDocument doc;
     doc.setObject(object);
 
-    HttpRequest* request = new HttpRequest();
-    request->setMethod("POST");
-    request->setUrl(m_endpoint + "/company/" + companyName + "/members/add");
-    request->setBody(new HttpBody(doc.toJson()));
+    HttpRequest request;
+    request.setMethod("POST");
+    request.setUrl(endpoint() + "/company/" + companyName + "/members/add");
+    request.setBody(new HttpBody(doc.toJson()));
 
     try {
-        HttpResponse* response = send(request);
+        GiantswarmResponse response = send(GiantswarmEndpoint::AddUserToCompany, request);
         assertStatusCode(response, STATUS_CODE_UPDATED);
     } catch (GiantswarmError& e) {
         qWarning() << "Error:" << e.errorString();
         return false;
     }
 
+    invalidateCache(GiantswarmEndpoint::CompanyUsers);
     return true;
 }
 
@@ -240,19 +456,20 @@ bool GiantswarmClient::removeUserFromCompany(QString companyName, QString userna
     QJsonDocument doc;
     doc.setObject(object);
 
-    HttpRequest* request = new HttpRequest();
-    request->setMethod("POST");
-    request->setUrl(m_endpoint + "/company/" + companyName + "/members/remove");
-    request->setBody(new HttpBody(doc.toJson()));
+    HttpRequest request;
+    request.setMethod("POST");
+    request.setUrl(endpoint() + "/company/" + companyName + "/members/remove");
+    request.setBody(new HttpBody(doc.toJson()));
 
     try {
-        HttpResponse* response = send(request);
+        GiantswarmResponse response = send(GiantswarmEndpoint::RemoveUserFromCompany, request);
         assertStatusCode(response, STATUS_CODE_UPDATED);
     } catch (GiantswarmError& e) {
         qWarning() << "Error:" << e.errorString();
         return false;
     }
 
+    invalidateCache(GiantswarmEndpoint::CompanyUsers);
     return true;
 }
 
@@ -279,6 +496,40 @@ bool GiantswarmClient::createEnvironment(QString companyName, QString environmen
     return true;
 }
 
+/**
+ * Creates all given environments at once. Returns one boolean per name
+ * telling whether it was newly created, or an empty list on failure.
+ */
+QVariantList GiantswarmClient::createEnvironments(QString companyName, QStringList environmentNames) {
+    QList<bool> added;
+    QVariantList results;
+
+    if (m_environments->addMany(companyName, environmentNames, &added)) {
+        foreach (bool result, added) {
+            results.append(result);
+        }
+    }
+
+    return results;
+}
+
+/**
+ * Like createEnvironments(), but also deletes all other environments of
+ * the company.
+ */
+QVariantList GiantswarmClient::replaceEnvironments(QString companyName, QStringList environmentNames) {
+    QList<bool> added;
+    QVariantList results;
+
+    if (m_environments->replaceAll(companyName, environmentNames, &added)) {
+        foreach (bool result, added) {
+            results.append(result);
+        }
+    }
+
+    return results;
+}
+
 bool GiantswarmClient::deleteEnvironment(QString companyName, QString environmentName) {
     return m_environments->remove(companyName, environmentName);
 }
@@ -287,127 +538,96 @@ bool GiantswarmClient::deleteEnvironment(QString companyName, QString environmen
  * Applications
  */
 
+/**
+ * Blocks on the pool rather than on a nested event loop, so no events of
+ * the calling thread are delivered in the meantime.
+ */
 QVariantList GiantswarmClient::getAllApplications() {
-    QVariantList applications;
-
-    foreach (QVariant company, getCompanies()) {
-        QString companyName = company.toString();
-
-        foreach (QVariant environment, getEnvironments()) {
-            QString environmentName = environment.toMap()["name"].toString();
-
-            foreach (QVariant application, getApplications(companyName, environmentName)) {
-                applications.append(application);
-            }
-        }
-    }
+    assertLoggedIn();
 
-    return applications;
+    AllApplicationsJob job(this, m_environments, 0, maxFanOut());
+    return job.run();
 }
 
 QVariantList GiantswarmClient::getApplications(QString companyName, QString environmentName) {
     assertLoggedIn();
 
-    HttpRequest* request = new HttpRequest();
-    request->setMethod("GET");
-    request->setUrl(m_endpoint + "/company/" + companyName + "/env/" + environmentName + "/app/");
-    HttpResponse* response;
+    HttpRequest request;
+    request.setMethod("GET");
+    request.setUrl(endpoint() + "/company/" + companyName + "/env/" + environmentName + "/app/");
+    GiantswarmResponse response;
 
     QVariantList applications;
+    ApplicationsDataReader data(&applications);
 
     try {
-        response = send(request);
+        response = send(GiantswarmEndpoint::Applications, QStringList() << companyName << environmentName, request);
+
+        {
+            GiantswarmMetrics::Timer timer(m_metrics, GiantswarmEndpoint::Applications, GiantswarmMetrics::Conversion);
+            response.read(&data);
+        }
+
         assertStatusCode(response, STATUS_CODE_SUCCESS);
     } catch (GiantswarmError& e) {
         qWarning() << "Error:" << e.errorString();
-        return applications;
-    }
-
-    QJsonArray data = extractDataAsArray(response);
-
-    for (int i = 0; i < data.size(); ++i) {
-        QJsonObject item = data.takeAt(i).toObject();
-
-        QVariantMap application;
-        application["company"] = item.take("company").toString();
-        application["environment"] = item.take("env").toString();
-        application["application"] = item.take("app").toString();
-        application["created_at"] = item.take("created").toString();
-
-        applications.append(application);
+        return QVariantList();
     }
 
     return applications;
 }
 
 QVariantMap GiantswarmClient::getApplicationStatus(QString companyName, QString environmentName, QString applicationName) {
-    assertLoggedIn();
-
-    HttpRequest* request = new HttpRequest();
-    request->setMethod("GET");
-    request->setUrl(m_endpoint + "/company/" + companyName + "/env/" + environmentName + "/app/" + applicationName + "/status");
-    HttpResponse* response;
+    return applicationStatus(companyName, environmentName, applicationName).toVariantMap();
+}
 
-    QVariantMap application;
-    application["name"] = "";
-    application["status"] = "";
-    application["services"] = QVariantList();
+ApplicationStatus GiantswarmClient::applicationStatus(QString companyName, QString environmentName, QString applicationName, bool *ok) {
+    assertLoggedIn();
 
-    try {
-        response = send(request);
-        assertStatusCode(response, STATUS_CODE_SUCCESS);
-    } catch (GiantswarmError& e) {
-        qWarning() << "Error:" << e.errorString();
-        return application;
+    if (ok) {
+        *ok = false;
     }
 
-    QJsonObject data = extractDataAsObject(response);
-
-    QVariantList services;
-    foreach (QJsonValue serviceElement, data["services"].toArray()) {
-        QJsonObject serviceItem = serviceElement.toObject();
+    HttpRequest request;
+    request.setMethod("GET");
+    request.setUrl(endpoint() + "/company/" + companyName + "/env/" + environmentName + "/app/" + applicationName + "/status");
+    GiantswarmResponse response;
 
-        QVariantList components;
-        foreach (QJsonValue componentElement, serviceItem["components"].toArray()) {
-            QJsonObject componentItem = componentElement.toObject();
+    ApplicationStatus application;
+    TypedDataReader<ApplicationStatus> data(&application);
 
-            QVariantList instances;
-            foreach (QJsonValue instanceElement, componentItem["instances"].toArray()) {
-                QJsonObject instanceItem = instanceElement.toObject();
-
-                QVariantMap instance;
-                instance["id"] = instanceItem["id"].toString();
-                instance["status"] = instanceItem["status"].toString();
-                instance["image"] = instanceItem["image"].toString();
-                instance["created_at"] = instanceItem["create_date"].toString();
-                instances.append(instance);
-            }
+    try {
+        response = send(GiantswarmEndpoint::ApplicationStatus, QStringList() << companyName << environmentName << applicationName, request);
 
-            QVariantMap component;
-            component["name"] = componentItem["name"].toString();
-            component["status"] = componentItem["status"].toString();
-            component["maximum"] = componentItem.take("max").toInt();
-            component["minimum"] = componentItem.take("min").toInt();
-            component["instances"] = instances;
-            components.append(component);
+        {
+            GiantswarmMetrics::Timer timer(m_metrics, GiantswarmEndpoint::ApplicationStatus, GiantswarmMetrics::Conversion);
+            response.read(&data);
         }
 
-        QVariantMap service;
-        service["name"] = serviceItem["name"].toString();
-        service["status"] = serviceItem["status"].toString();
-        service["maximum"] = serviceItem.take("max").toInt();
-        service["minimum"] = serviceItem.take("min").toInt();
-        service["components"] = components;
-        services.append(service);
+        assertStatusCode(response, STATUS_CODE_SUCCESS);
+    } catch (GiantswarmError& e) {
+        qWarning() << "Error:" << e.errorString();
+        return ApplicationStatus();
     }
 
-    application["name"] = data["name"].toString();
-    application["status"] = data["status"].toString();
-    application["services"] = services;
+    if (ok) {
+        *ok = true;
+    }
 
     return application;
 }
 
+/**
+ * Starts watching the status of an application. The watcher belongs to
+ * the client; delete it to stop watching.
+ */
+GiantswarmWatcher* GiantswarmClient::watchApplication(QString companyName, QString environmentName, QString applicationName, int interval) {
+    GiantswarmWatcher *watcher = new GiantswarmWatcher(this, companyName, environmentName, applicationName, interval, this);
+    watcher->start();
+
+    return watcher;
+}
+
 QVariantMap GiantswarmClient::getApplicationConfiguration(QString companyName, QString environmentName, QString applicationName) {
     Q_UNUSED(companyName);
     Q_UNUSED(environmentName);
@@ -419,36 +639,40 @@ QVariantMap GiantswarmClient::getApplicationConfiguration(QString companyName, Q
 bool GiantswarmClient::startApplication(QString companyName, QString environmentName, QString applicationName) {
     assertLoggedIn();
 
-    HttpRequest* request = new HttpRequest();
-    request->setMethod("POST");
-    request->setUrl(m_endpoint + "/company/" + companyName + "/env/" + environmentName + "/app/" + applicationName + "/start");
+    HttpRequest request;
+    request.setMethod("POST");
+    request.setUrl(endpoint() + "/company/" + companyName + "/env/" + environmentName + "/app/" + applicationName + "/start");
 
     try {
-        HttpResponse* response = send(request);
+        GiantswarmResponse response = send(GiantswarmEndpoint::StartApplication, request);
         assertStatusCode(response, STATUS_CODE_STARTED);
     } catch (GiantswarmError& e) {
         qWarning() << "Error:" << e.errorString();
         return false;
     }
 
+    invalidateCache(GiantswarmEndpoint::Applications);
+    invalidateCache(GiantswarmEndpoint::ApplicationStatus);
     return true;
 }
 
 bool GiantswarmClient::stopApplication(QString companyName, QString environmentName, QString applicationName) {
     assertLoggedIn();
 
-    HttpRequest* request = new HttpRequest();
-    request->setMethod("POST");
-    request->setUrl(m_endpoint + "/company/" + companyName + "/env/" + environmentName + "/app/" + applicationName + "/stop");
+    HttpRequest request;
+    request.setMethod("POST");
+    request.setUrl(endpoint() + "/company/" + companyName + "/env/" + environmentName + "/app/" + applicationName + "/stop");
 
     try {
-        HttpResponse* response = send(request);
+        GiantswarmResponse response = send(GiantswarmEndpoint::StopApplication, request);
         assertStatusCode(response, STATUS_CODE_STOPPED);
     } catch (GiantswarmError& e) {
         qWarning() << "Error:" << e.errorString();
         return false;
     }
 
+    invalidateCache(GiantswarmEndpoint::Applications);
+    invalidateCache(GiantswarmEndpoint::ApplicationStatus);
     return true;
 }
 
@@ -466,18 +690,19 @@ bool GiantswarmClient::scaleApplicationUp(QString companyName, QString environme
 bool GiantswarmClient::scaleApplicationUp(QString companyName, QString environmentName, QString applicationName, QString serviceName, QString componentName, int count) {
     assertLoggedIn();
 
-    HttpRequest* request = new HttpRequest();
-    request->setMethod("POST");
-    request->setUrl(m_endpoint + "/company/" + companyName + "/env/" + environmentName + "/app/" + applicationName + "/service/" + serviceName + "/component/" + componentName + "/scaleup/" + QString::number(count));
+    HttpRequest request;
+    request.setMethod("POST");
+    request.setUrl(endpoint() + "/company/" + companyName + "/env/" + environmentName + "/app/" + applicationName + "/service/" + serviceName + "/component/" + componentName + "/scaleup/" + QString::number(count));
 
     try {
-        HttpResponse* response = send(request);
+        GiantswarmResponse response = send(GiantswarmEndpoint::ScaleApplication, request);
         assertStatusCode(response, STATUS_CODE_UPDATED);
     } catch (GiantswarmError& e) {
         qWarning() << "Error:" << e.errorString();
         return false;
     }
 
+    invalidateCache(GiantswarmEndpoint::ApplicationStatus);
     return true;
 }
 
@@ -495,18 +720,19 @@ bool GiantswarmClient::scaleApplicationDown(QString companyName, QString environ
 bool GiantswarmClient::scaleApplicationDown(QString companyName, QString environmentName, QString applicationName, QString serviceName, QString componentName, int count) {
     assertLoggedIn();
 
-    HttpRequest* request = new HttpRequest();
-    request->setMethod("POST");
-    request->setUrl(m_endpoint + "/company/" + companyName + "/env/" + environmentName + "/app/" + applicationName + "/service/" + serviceName + "/component/" + componentName + "/scaleup/" + QString::number(count));
+    HttpRequest request;
+    request.setMethod("POST");
+    request.setUrl(endpoint() + "/company/" + companyName + "/env/" + environmentName + "/app/" + applicationName + "/service/" + serviceName + "/component/" + componentName + "/scaleup/" + QString::number(count));
 
     try {
-        HttpResponse* response = send(request);
+        GiantswarmResponse response = send(GiantswarmEndpoint::ScaleApplication, request);
         assertStatusCode(response, STATUS_CODE_DELETED);
     } catch (GiantswarmError& e) {
         qWarning() << "Error:" << e.errorString();
         return false;
     }
 
+    invalidateCache(GiantswarmEndpoint::ApplicationStatus);
     return true;
 }
 
@@ -515,35 +741,59 @@ bool GiantswarmClient::scaleApplicationDown(QString companyName, QString environ
  */
 
 QVariantMap GiantswarmClient::getInstanceStatistics(QString companyName, QString instanceId) {
+    bool ok = false;
+    InstanceStatistics statistics = instanceStatistics(companyName, instanceId, &ok);
+
+    return ok ? statistics.toVariantMap() : QVariantMap();
+}
+
+InstanceStatistics GiantswarmClient::instanceStatistics(QString companyName, QString instanceId, bool *ok) {
     assertLoggedIn();
 
-    HttpRequest* request = new HttpRequest();
-    request->setMethod("GET");
-    request->setUrl(m_endpoint + "/company/" + companyName + "/instance/" + instanceId + "/stats");
-    HttpResponse* response;
+    if (ok) {
+        *ok = false;
+    }
+
+    HttpRequest request;
+    request.setMethod("GET");
+    request.setUrl(endpoint() + "/company/" + companyName + "/instance/" + instanceId + "/stats");
+    GiantswarmResponse response;
 
-    QVariantMap statistics;
+    InstanceStatistics statistics;
+    TypedDataReader<InstanceStatistics> data(&statistics);
 
     try {
-        QString cacheKey("instance_statistics_" + instanceId);
-        response = send(cacheKey, request);
+        response = send(GiantswarmEndpoint::InstanceStatistics, QStringList() << companyName << instanceId, request);
+
+        {
+            GiantswarmMetrics::Timer timer(m_metrics, GiantswarmEndpoint::InstanceStatistics, GiantswarmMetrics::Conversion);
+            response.read(&data);
+        }
+
         assertStatusCode(response, STATUS_CODE_SUCCESS);
     } catch (GiantswarmError& e) {
         qWarning() << "Error:" << e.errorString();
-        return statistics;
+        return InstanceStatistics();
     }
 
-    QJsonObject data = extractDataAsObject(response);
-
-    statistics["component"] = data["ComponentName"].toString();
-    statistics["memory_usage_mb"] = data["MemoryUsageMb"].toDouble();
-    statistics["memory_capacity_mb"] = data["MemoryCapacityMb"].toDouble();
-    statistics["memory_usage_percent"] = data["MemoryUsagePercent"].toDouble();
-    statistics["cpu_usage_percent"] = data["CpuUsagePercent"].toDouble();
+    if (ok) {
+        *ok = true;
+    }
 
     return statistics;
 }
 
+/**
+ * Statistics of all instances of an application, grouped by component
+ * with sum, mean and 95th percentile of CPU and memory usage.
+ */
+QVariantMap GiantswarmClient::getApplicationStatistics(QString companyName, QString environmentName, QString applicationName) {
+    assertLoggedIn();
+
+    ApplicationStatisticsJob job(this, companyName, environmentName, applicationName, 0, maxFanOut());
+    return job.run();
+}
+
 /**
  * Account
  */
@@ -551,23 +801,24 @@ QVariantMap GiantswarmClient::getInstanceStatistics(QString companyName, QString
 QVariantMap GiantswarmClient::getUser() {
     assertLoggedIn();
 
-    HttpRequest* request = new HttpRequest();
-    request->setMethod("GET");
-    request->setUrl(m_endpoint + "/user/me");
-    HttpResponse* response;
+    HttpRequest request;
+    request.setMethod("GET");
+    request.setUrl(endpoint() + "/user/me");
+    GiantswarmResponse response;
 
     QVariantMap user;
     user["name"] = "";
     user["email"] = "";
 
     try {
-        response = send("user", request);
+        response = send(GiantswarmEndpoint::User, QStringList(), request);
         assertStatusCode(response, STATUS_CODE_SUCCESS);
     } catch (GiantswarmError& e) {
         qWarning() << "Error:" << e.errorString();
         return user;
     }
 
+    GiantswarmMetrics::Timer timer(m_metrics, GiantswarmEndpoint::User, GiantswarmMetrics::Conversion);
     QJsonObject data = extractDataAsObject(response);
 
     user["name"] = data.take("username").toString();
@@ -588,19 +839,20 @@ bool GiantswarmClient::updateEmail(QString email) {
     QJsonDocument doc;
     doc.setObject(object);
 
-    HttpRequest* request = new HttpRequest();
-    request->setMethod("POST");
-    request->setUrl(m_endpoint + "/user/me/email/update");
-    request->setBody(new HttpBody(doc.toJson()));
+    HttpRequest request;
+    request.setMethod("POST");
+    request.setUrl(endpoint() + "/user/me/email/update");
+    request.setBody(new HttpBody(doc.toJson()));
 
     try {
-        HttpResponse* response = send(request);
+        GiantswarmResponse response = send(GiantswarmEndpoint::UpdateEmail, request);
         assertStatusCode(response, STATUS_CODE_UPDATED);
     } catch (GiantswarmError& e) {
         qWarning() << "Error:" << e.errorString();
         return false;
     }
 
+    invalidateCache(GiantswarmEndpoint::User);
     return true;
 }
 
@@ -616,13 +868,13 @@ bool GiantswarmClient::updatePassword(QString old_password, QString new_password
     QJsonDocument doc;
     doc.setObject(object);
 
-    HttpRequest* request = new HttpRequest();
-    request->setMethod("POST");
-    request->setUrl(m_endpoint + "/user/me/password/update");
-    request->setBody(new HttpBody(doc.toJson()));
+    HttpRequest request;
+    request.setMethod("POST");
+    request.setUrl(endpoint() + "/user/me/password/update");
+    request.setBody(new HttpBody(doc.toJson()));
 
     try {
-        HttpResponse* response = send(request);
+        GiantswarmResponse response = send(GiantswarmEndpoint::UpdatePassword, request);
         assertStatusCode(response, STATUS_CODE_UPDATED);
     } catch (GiantswarmError& e) {
         qWarning() << "Error:" << e.errorString();
@@ -637,178 +889,723 @@ bool GiantswarmClient::updatePassword(QString old_password, QString new_password
  */
 
 bool GiantswarmClient::ping() {
-    HttpRequest* request = new HttpRequest();
-    request->setMethod("GET");
-    request->setUrl(m_endpoint + "/ping");
-    HttpResponse* response;
+    HttpRequest request;
+    request.setMethod("GET");
+    request.setUrl(endpoint() + "/ping");
+    GiantswarmResponse response;
 
     try {
-        response = send(request);
+        response = send(GiantswarmEndpoint::Ping, request);
     } catch (GiantswarmError& e) {
         qWarning() << "Error:" << e.errorString();
         return false;
     }
 
-    return response->body()->toString() == "\"OK\"\n";
+    return response.body() == "\"OK\"\n";
+}
+
+/**
+ * Metrics
+ */
+
+GiantswarmMetrics* GiantswarmClient::metrics() {
+    return m_metrics;
+}
+
+QVariantMap GiantswarmClient::getMetrics() {
+    return m_metrics->toVariantMap();
+}
+
+QString GiantswarmClient::getPrometheusMetrics() {
+    return m_metrics->toPrometheus();
+}
+
+/**
+ * Asynchronous API
+ *
+ * Each call runs its synchronous counterpart on the client's thread pool
+ * and reports back through the returned reply in the calling thread.
+ * Login, logout and the environment calls stay synchronous as they modify
+ * session state or touch the local database. getAllApplicationsAsync()
+ * fans out into up to setMaxFanOut() concurrent getApplications() calls.
+ */
+
+GiantswarmReply* GiantswarmClient::getCompaniesAsync() {
+    return invokeAsync(GiantswarmEndpoint::Companies, "getCompanies", "QVariantList");
+}
+
+GiantswarmReply* GiantswarmClient::hasCompaniesAsync() {
+    return invokeAsync(GiantswarmEndpoint::Companies, "hasCompanies", "bool");
+}
+
+GiantswarmReply* GiantswarmClient::createCompanyAsync(QString companyName) {
+    return invokeAsync(GiantswarmEndpoint::CreateCompany, "createCompany", "bool", QVariantList() << companyName);
+}
+
+GiantswarmReply* GiantswarmClient::deleteCompanyAsync(QString companyName) {
+    return invokeAsync(GiantswarmEndpoint::DeleteCompany, "deleteCompany", "bool", QVariantList() << companyName);
+}
+
+GiantswarmReply* GiantswarmClient::getCompanyUsersAsync(QString companyName) {
+    return invokeAsync(GiantswarmEndpoint::CompanyUsers, "getCompanyUsers", "QVariantList", QVariantList() << companyName);
+}
+
+GiantswarmReply* GiantswarmClient::addUserToCompanyAsync(QString companyName, QString username) {
+    return invokeAsync(GiantswarmEndpoint::AddUserToCompany, "addUserToCompany", "bool", QVariantList() << companyName << username);
+}
+
+GiantswarmReply* GiantswarmClient::removeUserFromCompanyAsync(QString companyName, QString username) {
+    return invokeAsync(GiantswarmEndpoint::RemoveUserFromCompany, "removeUserFromCompany", "bool", QVariantList() << companyName << username);
+}
+
+GiantswarmReply* GiantswarmClient::getAllApplicationsAsync() {
+    GiantswarmReply *reply = new GiantswarmReply();
+
+    AllApplicationsJob *job = new AllApplicationsJob(this, m_environments, reply, maxFanOut());
+    job->start();
+
+    return reply;
+}
+
+GiantswarmReply* GiantswarmClient::getApplicationsAsync(QString companyName, QString environmentName) {
+    return invokeAsync(GiantswarmEndpoint::Applications, "getApplications", "QVariantList", QVariantList() << companyName << environmentName);
+}
+
+GiantswarmReply* GiantswarmClient::getApplicationStatusAsync(QString companyName, QString environmentName, QString applicationName) {
+    return invokeAsync(GiantswarmEndpoint::ApplicationStatus, "getApplicationStatus", "QVariantMap", QVariantList() << companyName << environmentName << applicationName);
+}
+
+/**
+ * The reply's result holds an ApplicationStatus.
+ */
+GiantswarmReply* GiantswarmClient::applicationStatusAsync(QString companyName, QString environmentName, QString applicationName) {
+    return invokeAsync(GiantswarmEndpoint::ApplicationStatus, "applicationStatus", "ApplicationStatus", QVariantList() << companyName << environmentName << applicationName);
+}
+
+GiantswarmReply* GiantswarmClient::startApplicationAsync(QString companyName, QString environmentName, QString applicationName) {
+    return invokeAsync(GiantswarmEndpoint::StartApplication, "startApplication", "bool", QVariantList() << companyName << environmentName << applicationName);
+}
+
+GiantswarmReply* GiantswarmClient::stopApplicationAsync(QString companyName, QString environmentName, QString applicationName) {
+    return invokeAsync(GiantswarmEndpoint::StopApplication, "stopApplication", "bool", QVariantList() << companyName << environmentName << applicationName);
+}
+
+GiantswarmReply* GiantswarmClient::scaleApplicationUpAsync(QString companyName, QString environmentName, QString applicationName, QString serviceName, QString componentName) {
+    return scaleApplicationUpAsync(companyName, environmentName, applicationName, serviceName, componentName, 1);
+}
+
+GiantswarmReply* GiantswarmClient::scaleApplicationUpAsync(QString companyName, QString environmentName, QString applicationName, QString serviceName, QString componentName, int count) {
+    return invokeAsync(GiantswarmEndpoint::ScaleApplication, "scaleApplicationUp", "bool", QVariantList() << companyName << environmentName << applicationName << serviceName << componentName << count);
+}
+
+GiantswarmReply* GiantswarmClient::scaleApplicationDownAsync(QString companyName, QString environmentName, QString applicationName, QString serviceName, QString componentName) {
+    return scaleApplicationDownAsync(companyName, environmentName, applicationName, serviceName, componentName, 1);
+}
+
+GiantswarmReply* GiantswarmClient::scaleApplicationDownAsync(QString companyName, QString environmentName, QString applicationName, QString serviceName, QString componentName, int count) {
+    return invokeAsync(GiantswarmEndpoint::ScaleApplication, "scaleApplicationDown", "bool", QVariantList() << companyName << environmentName << applicationName << serviceName << componentName << count);
+}
+
+GiantswarmReply* GiantswarmClient::getInstanceStatisticsAsync(QString companyName, QString instanceId) {
+    return invokeAsync(GiantswarmEndpoint::InstanceStatistics, "getInstanceStatistics", "QVariantMap", QVariantList() << companyName << instanceId);
+}
+
+GiantswarmReply* GiantswarmClient::getApplicationStatisticsAsync(QString companyName, QString environmentName, QString applicationName) {
+    GiantswarmReply *reply = new GiantswarmReply();
+
+    ApplicationStatisticsJob *job = new ApplicationStatisticsJob(this, companyName, environmentName, applicationName, reply, maxFanOut());
+    job->start();
+
+    return reply;
+}
+
+GiantswarmReply* GiantswarmClient::getUserAsync() {
+    return invokeAsync(GiantswarmEndpoint::User, "getUser", "QVariantMap");
+}
+
+GiantswarmReply* GiantswarmClient::updateEmailAsync(QString email) {
+    return invokeAsync(GiantswarmEndpoint::UpdateEmail, "updateEmail", "bool", QVariantList() << email);
+}
+
+GiantswarmReply* GiantswarmClient::updatePasswordAsync(QString old_password, QString new_password) {
+    return invokeAsync(GiantswarmEndpoint::UpdatePassword, "updatePassword", "bool", QVariantList() << old_password << new_password);
+}
+
+GiantswarmReply* GiantswarmClient::pingAsync() {
+    return invokeAsync(GiantswarmEndpoint::Ping, "ping", "bool");
+}
+
+/**
+ * Queued calls are started in the order of their endpoint's priority, so a
+ * backlog of background polling does not delay interactive calls. The
+ * reply has no parent: it belongs to the calling thread, which may be a
+ * different one than the client's.
+ */
+GiantswarmReply* GiantswarmClient::invokeAsync(GiantswarmEndpoint::Endpoint endpoint, const char *method, const char *returnType, QVariantList args) {
+    GiantswarmReply *reply = new GiantswarmReply();
+    GiantswarmTask *task = new GiantswarmTask(this, method, returnType, args);
+
+    connect(
+        task, SIGNAL(completed(QVariant, int)),
+        reply, SLOT(complete(QVariant, int)),
+        Qt::QueuedConnection
+    );
+
+    startOnPool(task, endpoint);
+
+    return reply;
+}
+
+void GiantswarmClient::startOnPool(QRunnable *runnable, GiantswarmEndpoint::Endpoint endpoint) {
+    m_pool->start(runnable, m_governor->priority(endpoint));
+}
+
+void GiantswarmClient::invokeInBackground(const char *method, QVariantList args) {
+    GiantswarmTask *task = new GiantswarmTask(this, method, "", args);
+    m_pool->start(task, GiantswarmGovernor::Background);
 }
 
 /**
  * Caching
  */
 
+/**
+ * The client does not take ownership of the given adapter; it has to
+ * outlive the client. Adapters which are not a ConcurrentCacheAdapter
+ * are only ever called by one thread at a time.
+ */
 void GiantswarmClient::setCache(AbstractCacheAdapter *cache) {
-    m_cache = cache;
+    QWriteLocker locker(&m_cacheLock);
+
+    delete m_lockingCache;
+    m_lockingCache = 0;
+
+    if (!cache) {
+        cache = m_defaultCache;
+    }
+
+    m_cache = dynamic_cast<ConcurrentCacheAdapter*>(cache);
+    if (!m_cache) {
+        m_lockingCache = new LockingCacheAdapter(cache);
+        m_cache = m_lockingCache;
+    }
+
+    locker.unlock();
+
+    QMutexLocker generationsLocker(&m_generationsMutex);
+    m_generations.clear();
+}
+
+void GiantswarmClient::setCachePolicy(GiantswarmEndpoint::Endpoint endpoint, GiantswarmCachePolicy policy) {
+    QMutexLocker locker(&m_cacheMutex);
+    m_cachePolicies[endpoint] = policy;
+}
+
+GiantswarmCachePolicy GiantswarmClient::cachePolicy(GiantswarmEndpoint::Endpoint endpoint) {
+    QMutexLocker locker(&m_cacheMutex);
+    return m_cachePolicies.at(endpoint);
+}
+
+void GiantswarmClient::revalidate(int endpoint, QString cacheKey, QString url) {
+    HttpRequest request;
+    request.setMethod("GET");
+    request.setUrl(url);
+
+    GiantswarmCacheEntry cached;
+    fetchFromCache(cacheKey, &cached);
+
+    try {
+        refresh((GiantswarmEndpoint::Endpoint) endpoint, cacheKey, request, &cached);
+    } catch (GiantswarmError& e) {
+        qWarning() << "Failed to revalidate cache entry:" << e.errorString();
+    }
+
+    QMutexLocker locker(&m_cacheMutex);
+    m_revalidating.remove(cacheKey);
 }
 
 /**
  * HTTP handling
  */
 
-HttpResponse* GiantswarmClient::send(QString cacheKey, HttpRequest *request) {
-    if (m_cache->has(cacheKey)) {
-        try {
-            return generateResponseFromCachableString(m_cache->fetch(cacheKey));
-        } catch (GiantswarmError& e) {
-            qWarning() << "Failed to generate response from cache:" << e.errorString();
+GiantswarmResponse GiantswarmClient::send(GiantswarmEndpoint::Endpoint endpoint, QStringList parameters, HttpRequest& request) {
+    GiantswarmCachePolicy policy = cachePolicy(endpoint);
+
+    if (!policy.isCachable()) {
+        return send(endpoint, request);
+    }
+
+    QString cacheKey = generateCacheKey(endpoint, parameters);
+
+    GiantswarmCacheEntry cached;
+    bool hit = fetchFromCache(cacheKey, &cached);
+    qint64 age = cached.age();
+
+    if (hit) {
+        switch (policy.freshness(age)) {
+            case GiantswarmCachePolicy::Fresh:
+              m_metrics->recordCacheHit(endpoint);
+              return generateResponseFromCacheEntry(endpoint, cached);
+
+            case GiantswarmCachePolicy::Stale: {
+              m_metrics->recordCacheHit(endpoint);
+
+              QMutexLocker locker(&m_cacheMutex);
+              if (!m_revalidating.contains(cacheKey)) {
+                  m_revalidating.insert(cacheKey);
+                  invokeInBackground("revalidate", QVariantList() << (int) endpoint << cacheKey << request.url());
+              }
+              locker.unlock();
+
+              return generateResponseFromCacheEntry(endpoint, cached);
+            }
+
+            case GiantswarmCachePolicy::Expired:
+              break;
         }
     }
 
-    HttpResponse *response = send(request);
-    m_cache->store(cacheKey, generateCachableStringFromResponse(response));
+    m_metrics->recordCacheMiss(endpoint);
+
+    try {
+        return refresh(endpoint, cacheKey, request, &cached);
+    } catch (GiantswarmError& e) {
+        if (!hit || !policy.isUsableOnError(age)) {
+            throw;
+        }
+
+        qWarning() << "Serving stale response from cache:" << e.errorString();
+        resetLastError();
+    }
+
+    return generateResponseFromCacheEntry(endpoint, cached);
+}
+
+/**
+ * Requests the resource of a cache entry again, conditionally if the
+ * entry has validators. A 304 Not Modified only refreshes the entry;
+ * any other response replaces it.
+ */
+GiantswarmResponse GiantswarmClient::refresh(GiantswarmEndpoint::Endpoint endpoint, QString cacheKey, HttpRequest& request, GiantswarmCacheEntry *cached) {
+    GiantswarmResponse response = send(endpoint, request, cached->validators());
+
+    if (response.status() == HTTP_STATUS_NOT_MODIFIED) {
+        cached->refresh(response.headers());
+        storeInCache(cacheKey, *cached);
+        return generateResponseFromCacheEntry(endpoint, *cached);
+    }
+
+    storeInCache(cacheKey, response);
+    return response;
+}
+
+/**
+ * Identical GET requests running at the same time are coalesced: the
+ * first caller performs the request and every other caller waits for and
+ * shares its response, or its error. Requests are only coalesced with
+ * requests sent with the same session token and the same conditions, so
+ * no caller gets a response made for another session.
+ */
+GiantswarmResponse GiantswarmClient::send(GiantswarmEndpoint::Endpoint endpoint, HttpRequest& request, QMap<QString, QString> conditions) {
+    if (request.method() != "GET") {
+        return execute(endpoint, request, conditions);
+    }
+
+    QString key = request.method() + " " + request.url() + "\n" + token();
+
+    QMap<QString, QString>::const_iterator condition;
+    for (condition = conditions.constBegin(); condition != conditions.constEnd(); ++condition) {
+        key += "\n" + condition.key() + ": " + condition.value();
+    }
+
+    QMutexLocker locker(&m_flightsMutex);
+    Flight *flight = m_flights.value(key, 0);
+
+    if (flight) {
+        ++flight->waiters;
+        while (!flight->finished) {
+            flight->done.wait(&m_flightsMutex);
+        }
+
+        GiantswarmResponse response = flight->response;
+        int error = flight->error;
+
+        if (--flight->waiters == 0) {
+            delete flight;
+        }
+
+        locker.unlock();
+
+        if (error >= 0) {
+            throwError((GiantswarmError::Error) error);
+        }
+
+        return response;
+    }
+
+    flight = new Flight();
+    flight->finished = false;
+    flight->waiters = 0;
+    flight->error = -1;
+    m_flights.insert(key, flight);
+
+    locker.unlock();
+
+    GiantswarmResponse response;
+    int error = -1;
+
+    try {
+        response = execute(endpoint, request, conditions);
+    } catch (GiantswarmError& e) {
+        error = e.error;
+    }
+
+    locker.relock();
+
+    flight->response = response;
+    flight->error = error;
+    flight->finished = true;
+    m_flights.remove(key);
+
+    if (flight->waiters == 0) {
+        delete flight;
+    } else {
+        flight->done.wakeAll();
+    }
+
+    locker.unlock();
+
+    if (error >= 0) {
+        throwError((GiantswarmError::Error) error);
+    }
 
     return response;
 }
 
-HttpResponse* GiantswarmClient::send(HttpRequest *request) {
-    QMap<QString, QString> headers;
+GiantswarmResponse GiantswarmClient::execute(GiantswarmEndpoint::Endpoint endpoint, HttpRequest& request, QMap<QString, QString> conditions) {
+    QMap<QString, QString> headers = conditions;
     headers["Accept"] = "application/json";
     headers["User-Agent"] = "bb-giantswarm/0.0.1";
+    headers["Connection"] = "keep-alive";
 
-    if (!m_token.isEmpty()) {
-        headers["Authorization"] = "giantswarm " + m_token;
+    QString token = this->token();
+    if (!token.isEmpty()) {
+        headers["Authorization"] = "giantswarm " + token;
     }
 
-    if (!request->body()->isEmpty()) {
+    if (!request.body()->isEmpty()) {
         headers["Content-Type"] = "application/json";
     }
 
-    request->setHeaders(headers);
+    request.setHeaders(headers);
+
+    GiantswarmRetryPolicy policy = retryPolicy(GiantswarmEndpoint::idempotency(endpoint));
+    GiantswarmConnection::Response response;
+    QByteArray payload = request.body()->toByteArray();
+
+    QString company = companyOf(request.url());
+
+    m_retryBudget.deposit();
+
+    for (int attempt = 1; ; ++attempt) {
+        bool sent;
+
+        {
+            GiantswarmGovernor::Lease admission(m_governor, endpoint, company);
+            GiantswarmConnectionPool::Lease connection(m_connections, request.url());
+            GiantswarmMetrics::Timer timer(m_metrics, endpoint, GiantswarmMetrics::Network);
+            sent = connection.connection()->send(request.method(), QUrl(request.url()), headers, payload, &response);
+        }
+
+        if (!sent) {
+            response.status = 0;
+            response.headers.clear();
+            response.body.clear();
+        }
+
+        m_metrics->recordRequest(endpoint, payload.size(), response.body.size());
+
+        bool retryable = !sent || response.status >= 500 || response.status == HTTP_STATUS_TOO_MANY_REQUESTS;
+        int wait = retryable ? policy.delay(attempt) : 0;
+
+        // The server's own estimate wins over the backoff; one asking for
+        // longer than is worth blocking for gets its error right away.
+        if (retryable && (response.status == HTTP_STATUS_TOO_MANY_REQUESTS || response.status == HTTP_STATUS_SERVICE_UNAVAILABLE)) {
+            int retryAfter = GiantswarmRetryPolicy::retryAfter(GiantswarmConnection::header(response.headers, "Retry-After"));
+            if (retryAfter > MAX_RETRY_AFTER * 1000) {
+                retryable = false;
+            } else {
+                wait = qMax(wait, retryAfter);
+            }
+        }
+
+        if (!retryable || !policy.allowsRetry(attempt) || !m_retryBudget.withdraw()) {
+            break;
+        }
+
+        qWarning() << "Retrying" << GiantswarmEndpoint::name(endpoint) << "after status" << response.status;
+        pause(wait);
+    }
+
+    // Only a conditional request can legitimately be answered with 304; it
+    // is passed on without a body for the caller to refresh its entry.
+    if (response.status == HTTP_STATUS_NOT_MODIFIED && !conditions.isEmpty()) {
+        GiantswarmResponse result(response.status, response.headers, QByteArray());
+        result.setEndpoint(endpoint);
+        return result;
+    }
 
-    HttpResponse* response = m_httpclient->send(request);
+    int error = -1;
+    int status = response.status;
+
+    if (status == 403) {
+        error = GiantswarmError::NotAllowedToRequestURI;
+    } else if (status >= 400 && status < 500) {
+        error = GiantswarmError::ClientError;
+    } else if (status >= 500 && status < 600) {
+        error = GiantswarmError::ServerError;
+    } else if (status >= 300 && status < 400) {
+        error = GiantswarmError::ResponseContainsRedirection;
+    } else if (status < 200 || status >= 300) {
+        error = GiantswarmError::UnexpectedResponseStatus;
+    }
 
-    if (response->isForbidden()) {
-        throwError(GiantswarmError::NotAllowedToRequestURI);
-    } else if (response->isClientError()) {
-        throwError(GiantswarmError::ClientError);
-    } else if (response->isServerError()) {
-        throwError(GiantswarmError::ServerError);
-    } else if (response->isRedirection()) {
-        throwError(GiantswarmError::ResponseContainsRedirection);
-    } else if (response->isNotFound()) {
-        throwError(GiantswarmError::NotFound);
-    } else if (!response->isSuccessful()) {
-        throwError(GiantswarmError::UnexpectedResponseStatus);
+    if (error >= 0) {
+        m_metrics->recordError(endpoint, (GiantswarmError::Error) error);
+        throwError((GiantswarmError::Error) error);
     }
 
-    return response;
+    GiantswarmMetrics::Timer timer(m_metrics, endpoint, GiantswarmMetrics::Parse);
+
+    GiantswarmResponse result(response.status, response.headers, response.body, parseMode(endpoint));
+    result.setEndpoint(endpoint);
+
+    return result;
 }
 
 /**
- * Example:
- *
- *   {
- *     "status": 200,
- *     "headers": [ { "name": "Content-Type", "value": "application/json" } ],
- *     "body": "{\"result\":\"success\"}"
- *   }
- *
+ * The company a request URL refers to, or an empty string for requests
+ * that are not made on behalf of a company.
  */
-QString GiantswarmClient::generateCachableStringFromResponse(HttpResponse* response) {
-    QMap<QString, QString> responseHeaders = response->headers();
-
-    QJsonArray headers;
-    foreach (QString key, responseHeaders.keys()) {
-        QJsonObject header;
-        header["name"] = QJsonValue(key);
-        header["value"] = QJsonValue(responseHeaders[key]);
-        headers.append(QJsonValue(headers));
+QString GiantswarmClient::companyOf(const QString& url) {
+    int start = url.indexOf("/company/");
+    if (start < 0) {
+        return QString();
     }
 
-    QJsonObject object;
-    object["status"] = QJsonValue(response->status());
-    object["headers"] = QJsonValue(headers);
-    object["body"] = QJsonValue(response->body()->toString());
+    start += 9;
+    int end = url.indexOf('/', start);
 
-    QJsonDocument doc;
-    doc.setObject(object);
+    return url.mid(start, end < 0 ? -1 : end - start);
+}
+
+/**
+ * Sleeps the calling thread without needing an event loop.
+ */
+void GiantswarmClient::pause(int msecs) {
+    if (msecs <= 0) {
+        return;
+    }
 
-    return QString(doc.toJson());
+    QMutex mutex;
+    QWaitCondition condition;
+
+    mutex.lock();
+    condition.wait(&mutex, msecs);
+    mutex.unlock();
 }
 
-HttpResponse* GiantswarmClient::generateResponseFromCachableString(QString string) {
-    QJsonParseError err;
-    QJsonDocument doc = QJsonDocument::fromJson(string.toUtf8(), &err);
+/**
+ * Responses which can get large are decoded straight from their bytes by
+ * a GiantswarmJsonReader in a single pass, so no document is built for
+ * them.
+ */
+GiantswarmResponse::ParseMode GiantswarmClient::parseMode(GiantswarmEndpoint::Endpoint endpoint) {
+    switch (endpoint) {
+        case GiantswarmEndpoint::Applications:
+        case GiantswarmEndpoint::ApplicationStatus:
+        case GiantswarmEndpoint::InstanceStatistics:
+          return GiantswarmResponse::Streamed;
+
+        default:
+          return GiantswarmResponse::ParseDocument;
+    }
+}
 
-    if (doc.isNull()) {
-        throwError(GiantswarmError::InvalidJsonFromCache);
+/**
+ * Cache keys are a SHA-1 over the endpoint, the API the client talks to,
+ * the identity of the session, the path parameters and the endpoint's
+ * generation, which changes whenever a mutation invalidates its responses.
+ * Entries of different users and companies therefore never collide and
+ * neither accounts nor tokens end up in the cache in plain text.
+ */
+QString GiantswarmClient::generateCacheKey(GiantswarmEndpoint::Endpoint endpoint, QStringList parameters) {
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(GiantswarmEndpoint::name(endpoint).toUtf8());
+    hash.addData(QByteArray(1, '\0'));
+    hash.addData(this->endpoint().toUtf8());
+    hash.addData(QByteArray(1, '\0'));
+    hash.addData(identity().toUtf8());
+
+    foreach (QString parameter, parameters) {
+        hash.addData(QByteArray(1, '\0'));
+        hash.addData(parameter.toUtf8());
     }
 
-    QJsonObject object = doc.object();
-    QJsonArray headers = object.take("headers").toArray();
+    hash.addData(QByteArray(1, '\0'));
+    hash.addData(cacheGeneration(endpoint).toUtf8());
 
-    QMap<QString, QString> responseHeaders;
-    for (int i = 0; i < headers.size(); ++i) {
-        QJsonObject header = headers.at(i).toObject();
-        QString name = header.take("name").toString();
-        QString value = header.take("value").toString();
-        responseHeaders[name] = value;
-    }
+    return "giantswarm_" + QString(hash.result().toHex());
+}
 
-    HttpResponse *response = new HttpResponse(
-        object.take("status").toInt(),
-        responseHeaders,
-        new HttpBody(object.take("body").toString())
-    );
+/**
+ * Invalidation moves an endpoint to a new generation, which is part of
+ * every cache key of the endpoint. Generations are kept in the cache
+ * itself, so they survive restarts and are seen by every process sharing
+ * a persistent cache. A generation that is missing, e.g. because it was
+ * evicted, is replaced by a new one rather than a default, so entries of
+ * an earlier generation can never become reachable again.
+ */
+void GiantswarmClient::invalidateCache(GiantswarmEndpoint::Endpoint endpoint) {
+    QString key = generationKey(endpoint);
+    QString generation = QUuid::createUuid().toString();
 
-    return response;
+    QMutexLocker locker(&m_generationsMutex);
+
+    m_cacheLock.lockForRead();
+    m_cache->store(key, generation);
+    m_cacheLock.unlock();
+
+    m_generations[key].value = generation;
+    m_generations[key].checkedAt.start();
 }
 
 /**
- * Helpers
+ * Generations are remembered and only read from the cache again once per
+ * refresh interval, which bounds how long an invalidation by another
+ * process goes unnoticed. Lookups are serialized, so threads of this
+ * process always agree on a new generation.
  */
+QString GiantswarmClient::cacheGeneration(GiantswarmEndpoint::Endpoint endpoint) {
+    QString key = generationKey(endpoint);
+
+    QMutexLocker locker(&m_generationsMutex);
+    Generation& generation = m_generations[key];
 
-QJsonObject GiantswarmClient::extractDataAsObject(HttpResponse* response) {
-    QByteArray json = response->body()->toByteArray();
+    if (generation.checkedAt.isValid() && generation.checkedAt.elapsed() < CACHE_GENERATION_REFRESH_INTERVAL) {
+        return generation.value;
+    }
 
-    QJsonParseError err;
-    QJsonDocument doc = QJsonDocument::fromJson(json, &err);
+    QString value;
+    QReadLocker cacheLocker(&m_cacheLock);
 
-    if (doc.isNull()) {
-        qWarning() << "Failed to parse JSON:" << err.errorString();
-        return QJsonObject();
+    if (!m_cache->lookup(key, &value) || value.isEmpty()) {
+        value = QUuid::createUuid().toString();
+        m_cache->store(key, value);
+
+        // Another process may have stored its own at the same time; the
+        // one the cache kept wins.
+        QString kept;
+        if (m_cache->lookup(key, &kept) && !kept.isEmpty()) {
+            value = kept;
+        }
     }
 
-    return doc.object()["data"].toObject();
+    generation.value = value;
+    generation.checkedAt.start();
+
+    return value;
+}
+
+QString GiantswarmClient::generationKey(GiantswarmEndpoint::Endpoint endpoint) {
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(GiantswarmEndpoint::name(endpoint).toUtf8());
+    hash.addData(QByteArray(1, '\0'));
+    hash.addData(this->endpoint().toUtf8());
+
+    return "giantswarm_generation_" + QString(hash.result().toHex());
 }
 
-QJsonArray GiantswarmClient::extractDataAsArray(HttpResponse* response) {
-    QByteArray json = response->body()->toByteArray();
+bool GiantswarmClient::fetchFromCache(QString cacheKey, GiantswarmCacheEntry *entry) {
+    QString string;
 
-    QJsonParseError err;
-    QJsonDocument doc = QJsonDocument::fromJson(json, &err);
+    QReadLocker locker(&m_cacheLock);
+    bool found = m_cache->lookup(cacheKey, &string);
+    locker.unlock();
 
-    if (doc.isNull()) {
-        qWarning() << "Failed to parse JSON:" << err.errorString();
-        return QJsonArray();
+    if (!found) {
+        return false;
+    }
+
+    if (!entry->fromCachableString(string)) {
+        GiantswarmError err;
+        err.error = GiantswarmCacheEntry::isLegacyString(string)
+            ? GiantswarmError::InvalidJsonFromCache
+            : GiantswarmError::InvalidCacheEntry;
+
+        qWarning() << "Failed to generate response from cache:" << err.errorString();
+        return false;
     }
 
-    return doc.object()["data"].toArray();
+    return true;
+}
+
+GiantswarmResponse GiantswarmClient::generateResponseFromCacheEntry(GiantswarmEndpoint::Endpoint endpoint, const GiantswarmCacheEntry& entry) {
+    GiantswarmMetrics::Timer timer(m_metrics, endpoint, GiantswarmMetrics::Parse);
+
+    GiantswarmResponse response = entry.toResponse(parseMode(endpoint));
+    response.setEndpoint(endpoint);
+
+    return response;
+}
+
+void GiantswarmClient::storeInCache(QString cacheKey, const GiantswarmResponse& response) {
+    storeInCache(cacheKey, GiantswarmCacheEntry(response));
+}
+
+void GiantswarmClient::storeInCache(QString cacheKey, const GiantswarmCacheEntry& entry) {
+    QString string = entry.toCachableString();
+
+    QReadLocker locker(&m_cacheLock);
+    m_cache->store(cacheKey, string);
+}
+
+/**
+ * Helpers
+ */
+
+QJsonObject GiantswarmClient::extractDataAsObject(const GiantswarmResponse& response) {
+    return response.data().toObject();
+}
+
+QJsonArray GiantswarmClient::extractDataAsArray(const GiantswarmResponse& response) {
+    return response.data().toArray();
 }
 
 /**
  * Assertions
  */
 
+QString GiantswarmClient::endpoint() const {
+    QReadLocker locker(&m_settingsLock);
+    return m_endpoint;
+}
+
+QString GiantswarmClient::token() const {
+    QReadLocker locker(&m_settingsLock);
+    return m_token;
+}
+
+QString GiantswarmClient::identity() const {
+    QReadLocker locker(&m_settingsLock);
+    return m_identity.isEmpty() ? "token:" + m_token : "user:" + m_identity;
+}
+
+int GiantswarmClient::maxFanOut() const {
+    QReadLocker locker(&m_settingsLock);
+    return m_maxFanOut;
+}
+
 void GiantswarmClient::assertLoggedIn() {
     if (!isLoggedIn()) {
         throwError(GiantswarmError::LoginRequired);
@@ -821,19 +1618,24 @@ void GiantswarmClient::assertNotLoggedIn() {
     }
 }
 
-void GiantswarmClient::assertStatusCode(HttpResponse* response, int status) {
-    QByteArray data = response->body()->toByteArray();
+void GiantswarmClient::assertStatusCode(const GiantswarmResponse& response, int status) {
+    int error = -1;
 
-    QJsonParseError err;
-    QJsonDocument doc = QJsonDocument::fromJson(data, &err);
+    if (!response.isValid()) {
+        error = GiantswarmError::InvalidJsonFromAPI;
+    } else if (response.statusCode() != status) {
+        error = GiantswarmError::ResponseStatusMismatch;
+    }
 
-    if (doc.isNull()) {
-        throwError(GiantswarmError::InvalidJsonFromAPI);
+    if (error < 0) {
+        return;
     }
 
-    if ((int)doc.object()["status_code"].toDouble() != status) {
-        throwError(GiantswarmError::ResponseStatusMismatch);
+    if (response.endpoint() >= 0) {
+        m_metrics->recordError((GiantswarmEndpoint::Endpoint) response.endpoint(), (GiantswarmError::Error) error);
     }
+
+    throwError((GiantswarmError::Error) error);
 }
 
 /**
@@ -841,7 +1643,25 @@ void GiantswarmClient::assertStatusCode(HttpResponse* response, int status) {
  */
 
 void GiantswarmClient::throwError(GiantswarmError::Error e) {
+    if (!m_lastErrors.hasLocalData()) {
+        m_lastErrors.setLocalData(new int(-1));
+    }
+    *m_lastErrors.localData() = e;
+
     GiantswarmError err;
     err.error = e;
     throw err;
 }
+
+void GiantswarmClient::resetLastError() {
+    if (m_lastErrors.hasLocalData()) {
+        *m_lastErrors.localData() = -1;
+    }
+}
+
+int GiantswarmClient::lastError() {
+    if (!m_lastErrors.hasLocalData()) {
+        return -1;
+    }
+    return *m_lastErrors.localData();
+}
@@ -1,16 +1,39 @@
 #ifndef BIDSTACK_GIANTSWARM_CLIENT_HPP
 #define BIDSTACK_GIANTSWARM_CLIENT_HPP
 
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
 #include <QObject>
+#include <QReadWriteLock>
+#include <QSet>
+#include <QStringList>
+#include <QThreadPool>
+#include <QThreadStorage>
 #include <QVariantList>
 #include <QVariantMap>
+#include <QVector>
+#include <QWaitCondition>
 
+#include "giantswarmcacheentry.hpp"
+#include "giantswarmcachepolicy.hpp"
+#include "giantswarmconnectionpool.hpp"
+#include "giantswarmendpoint.hpp"
 #include "giantswarmerror.hpp"
+#include "giantswarmgovernor.hpp"
+#include "giantswarmmetrics.hpp"
+#include "giantswarmreply.hpp"
+#include "giantswarmresponse.hpp"
+#include "giantswarmretrybudget.hpp"
+#include "giantswarmretrypolicy.hpp"
+#include "giantswarmstorageprofile.hpp"
+#include "giantswarmtypes.hpp"
+#include "giantswarmwatcher.hpp"
+#include "caches/concurrentcacheadapter.hpp"
+#include "caches/lockingcacheadapter.hpp"
 #include "repositories/environmentrepository.hpp"
 
-#include "deps/http/httpclient.hpp"
 #include "deps/http/httprequest.hpp"
-#include "deps/http/httpresponse.hpp"
 
 #include "deps/cache/abstractcacheadapter.hpp"
 
@@ -19,6 +42,7 @@
 
 using namespace Bidstack::Http;
 using namespace Bidstack::Cache;
+using namespace Bidstack::Giantswarm::Caches;
 using namespace Bidstack::Giantswarm::Repositories;
 
 namespace Bidstack {
@@ -31,21 +55,63 @@ namespace Bidstack {
         const int STATUS_CODE_UPDATED = 10006;
         const int STATUS_CODE_DELETED = 10007;
 
+        const int HTTP_STATUS_NOT_MODIFIED = 304;
+        const int HTTP_STATUS_TOO_MANY_REQUESTS = 429;
+        const int HTTP_STATUS_SERVICE_UNAVAILABLE = 503;
+
+        const int DEFAULT_MAX_CONCURRENT_REQUESTS = 8;
+        const int DEFAULT_MAX_FAN_OUT = 8;
+        const int CACHE_GENERATION_REFRESH_INTERVAL = 1000;
+
+        class GiantswarmBatch;
+        class GiantswarmTask;
+        class GiantswarmWatcher;
+
+        /**
+         * All public methods may be called from any thread. The endpoint,
+         * the session token and the other settings are read under a lock
+         * and copied per request, cache adapters which do not implement
+         * ConcurrentCacheAdapter are wrapped in a LockingCacheAdapter and
+         * environments are read through per-thread database connections.
+         * Settings are meant to be configured once before the client is
+         * shared; the token may be replaced at any time.
+         */
         class GiantswarmClient : public QObject {
             Q_OBJECT
 
+            friend class GiantswarmBatch;
+            friend class GiantswarmTask;
+            friend class GiantswarmWatcher;
+
         public:
             GiantswarmClient(QSqlDatabase& database, QObject *parent = 0);
+            ~GiantswarmClient();
 
         public:
             void setCache(AbstractCacheAdapter *cache);
+            void setCachePolicy(GiantswarmEndpoint::Endpoint endpoint, GiantswarmCachePolicy policy);
+            GiantswarmCachePolicy cachePolicy(GiantswarmEndpoint::Endpoint endpoint);
             void setEndpoint(QString endpoint);
+            void setMaxConcurrentRequests(int count);
+            void setMaxFanOut(int count);
+            void setMaxConcurrentRequestsPerHost(int count);
+            void setConnectionIdleTimeout(int seconds);
+            void setSslConfiguration(const QSslConfiguration& configuration);
+            void setStorageProfile(const GiantswarmStorageProfile& profile);
+            void setRetryPolicy(GiantswarmEndpoint::Idempotency idempotency, GiantswarmRetryPolicy policy);
+            GiantswarmRetryPolicy retryPolicy(GiantswarmEndpoint::Idempotency idempotency) const;
+            void setRetryBudget(double ratio, int maxTokens);
+            void setRateLimit(const GiantswarmRateLimit& limit);
+            void setCompanyRateLimit(const GiantswarmRateLimit& limit);
+            void setCompanyRateLimit(QString companyName, const GiantswarmRateLimit& limit);
+            void setCategoryRateLimit(GiantswarmEndpoint::Category category, const GiantswarmRateLimit& limit);
+            void setPriority(GiantswarmEndpoint::Category category, GiantswarmGovernor::Priority priority);
 
         public:
             Q_INVOKABLE bool login(QString email, QString password);
             Q_INVOKABLE bool logout();
             Q_INVOKABLE bool isLoggedIn();
-            Q_INVOKABLE void setToken(QString token);
+            Q_INVOKABLE void setToken(QString token, QString identity = QString());
 
             Q_INVOKABLE QVariantList getCompanies();
             Q_INVOKABLE bool hasCompanies();
@@ -60,11 +126,15 @@ namespace Bidstack {
             Q_INVOKABLE bool hasEnvironments();
             Q_INVOKABLE bool hasEnvironment(QString companyName, QString environmentName);
             Q_INVOKABLE bool createEnvironment(QString companyName, QString environmentName);
+            Q_INVOKABLE QVariantList createEnvironments(QString companyName, QStringList environmentNames);
+            Q_INVOKABLE QVariantList replaceEnvironments(QString companyName, QStringList environmentNames);
             Q_INVOKABLE bool deleteEnvironment(QString companyName, QString environmentName);
 
             Q_INVOKABLE QVariantList getAllApplications();
             Q_INVOKABLE QVariantList getApplications(QString companyName, QString environmentName);
             Q_INVOKABLE QVariantMap getApplicationStatus(QString companyName, QString environmentName, QString applicationName);
+            Q_INVOKABLE ApplicationStatus applicationStatus(QString companyName, QString environmentName, QString applicationName, bool *ok = 0);
+            Q_INVOKABLE GiantswarmWatcher* watchApplication(QString companyName, QString environmentName, QString applicationName, int interval = DEFAULT_WATCH_INTERVAL);
             Q_INVOKABLE QVariantMap getApplicationConfiguration(QString companyName, QString environmentName, QString applicationName);
             Q_INVOKABLE bool startApplication(QString companyName, QString environmentName, QString applicationName);
             Q_INVOKABLE bool stopApplication(QString companyName, QString environmentName, QString applicationName);
@@ -74,6 +144,8 @@ namespace Bidstack {
             Q_INVOKABLE bool scaleApplicationDown(QString companyName, QString environmentName, QString applicationName, QString serviceName, QString componentName, int count);
 
             Q_INVOKABLE QVariantMap getInstanceStatistics(QString companyName, QString instanceId);
+            Q_INVOKABLE QVariantMap getApplicationStatistics(QString companyName, QString environmentName, QString applicationName);
+            Q_INVOKABLE InstanceStatistics instanceStatistics(QString companyName, QString instanceId, bool *ok = 0);
 
             Q_INVOKABLE QVariantMap getUser();
             Q_INVOKABLE bool updateEmail(QString email);
@@ -81,28 +153,123 @@ namespace Bidstack {
 
             Q_INVOKABLE bool ping();
 
+            GiantswarmMetrics* metrics();
+            Q_INVOKABLE QVariantMap getMetrics();
+            Q_INVOKABLE QString getPrometheusMetrics();
+
+        public:
+            Q_INVOKABLE GiantswarmReply* getCompaniesAsync();
+            Q_INVOKABLE GiantswarmReply* hasCompaniesAsync();
+            Q_INVOKABLE GiantswarmReply* createCompanyAsync(QString companyName);
+            Q_INVOKABLE GiantswarmReply* deleteCompanyAsync(QString companyName);
+
+            Q_INVOKABLE GiantswarmReply* getCompanyUsersAsync(QString companyName);
+            Q_INVOKABLE GiantswarmReply* addUserToCompanyAsync(QString companyName, QString username);
+            Q_INVOKABLE GiantswarmReply* removeUserFromCompanyAsync(QString companyName, QString username);
+
+            Q_INVOKABLE GiantswarmReply* getAllApplicationsAsync();
+            Q_INVOKABLE GiantswarmReply* getApplicationsAsync(QString companyName, QString environmentName);
+            Q_INVOKABLE GiantswarmReply* getApplicationStatusAsync(QString companyName, QString environmentName, QString applicationName);
+            GiantswarmReply* applicationStatusAsync(QString companyName, QString environmentName, QString applicationName);
+            Q_INVOKABLE GiantswarmReply* startApplicationAsync(QString companyName, QString environmentName, QString applicationName);
+            Q_INVOKABLE GiantswarmReply* stopApplicationAsync(QString companyName, QString environmentName, QString applicationName);
+            Q_INVOKABLE GiantswarmReply* scaleApplicationUpAsync(QString companyName, QString environmentName, QString applicationName, QString serviceName, QString componentName);
+            Q_INVOKABLE GiantswarmReply* scaleApplicationUpAsync(QString companyName, QString environmentName, QString applicationName, QString serviceName, QString componentName, int count);
+            Q_INVOKABLE GiantswarmReply* scaleApplicationDownAsync(QString companyName, QString environmentName, QString applicationName, QString serviceName, QString componentName);
+            Q_INVOKABLE GiantswarmReply* scaleApplicationDownAsync(QString companyName, QString environmentName, QString applicationName, QString serviceName, QString componentName, int count);
+
+            Q_INVOKABLE GiantswarmReply* getInstanceStatisticsAsync(QString companyName, QString instanceId);
+            Q_INVOKABLE GiantswarmReply* getApplicationStatisticsAsync(QString companyName, QString environmentName, QString applicationName);
+
+            Q_INVOKABLE GiantswarmReply* getUserAsync();
+            Q_INVOKABLE GiantswarmReply* updateEmailAsync(QString email);
+            Q_INVOKABLE GiantswarmReply* updatePasswordAsync(QString old_password, QString new_password);
+
+            Q_INVOKABLE GiantswarmReply* pingAsync();
+
+        private slots:
+            void revalidate(int endpoint, QString cacheKey, QString url);
+
         private:
-            HttpResponse* send(QString cacheKey, HttpRequest *request);
-            HttpResponse* send(HttpRequest *request);
+            GiantswarmReply* invokeAsync(GiantswarmEndpoint::Endpoint endpoint, const char *method, const char *returnType, QVariantList args = QVariantList());
+            void invokeInBackground(const char *method, QVariantList args);
+            void startOnPool(QRunnable *runnable, GiantswarmEndpoint::Endpoint endpoint);
+
+            GiantswarmResponse send(GiantswarmEndpoint::Endpoint endpoint, QStringList parameters, HttpRequest& request);
+            GiantswarmResponse send(GiantswarmEndpoint::Endpoint endpoint, HttpRequest& request, QMap<QString, QString> conditions = QMap<QString, QString>());
+            GiantswarmResponse execute(GiantswarmEndpoint::Endpoint endpoint, HttpRequest& request, QMap<QString, QString> conditions = QMap<QString, QString>());
+            GiantswarmResponse refresh(GiantswarmEndpoint::Endpoint endpoint, QString cacheKey, HttpRequest& request, GiantswarmCacheEntry *cached);
+            static GiantswarmResponse::ParseMode parseMode(GiantswarmEndpoint::Endpoint endpoint);
+            static QString companyOf(const QString& url);
+            static void pause(int msecs);
 
-            QString generateCachableStringFromResponse(HttpResponse *response);
-            HttpResponse* generateResponseFromCachableString(QString string);
+            QString generateCacheKey(GiantswarmEndpoint::Endpoint endpoint, QStringList parameters);
+            void invalidateCache(GiantswarmEndpoint::Endpoint endpoint);
+            QString cacheGeneration(GiantswarmEndpoint::Endpoint endpoint);
+            QString generationKey(GiantswarmEndpoint::Endpoint endpoint);
+            bool fetchFromCache(QString cacheKey, GiantswarmCacheEntry *entry);
+            GiantswarmResponse generateResponseFromCacheEntry(GiantswarmEndpoint::Endpoint endpoint, const GiantswarmCacheEntry& entry);
+            void storeInCache(QString cacheKey, const GiantswarmResponse& response);
+            void storeInCache(QString cacheKey, const GiantswarmCacheEntry& entry);
 
-            QJsonObject extractDataAsObject(HttpResponse* response);
-            QJsonArray extractDataAsArray(HttpResponse* response);
+            QJsonObject extractDataAsObject(const GiantswarmResponse& response);
+            QJsonArray extractDataAsArray(const GiantswarmResponse& response);
+
+            QString endpoint() const;
+            QString token() const;
+            QString identity() const;
+            int maxFanOut() const;
 
             void assertLoggedIn();
             void assertNotLoggedIn();
-            void assertStatusCode(HttpResponse* response, int status);
+            void assertStatusCode(const GiantswarmResponse& response, int status);
 
             void throwError(GiantswarmError::Error e);
+            void resetLastError();
+            int lastError();
 
         private:
             QString m_token;
+            QString m_identity;
             QString m_endpoint;
-            HttpClient *m_httpclient;
-            AbstractCacheAdapter *m_cache;
+            int m_maxFanOut;
+            QVector<GiantswarmRetryPolicy> m_retryPolicies;
+            mutable QReadWriteLock m_settingsLock;
+            GiantswarmRetryBudget m_retryBudget;
+
+            GiantswarmConnectionPool *m_connections;
+            GiantswarmGovernor *m_governor;
+            GiantswarmMetrics *m_metrics;
+            ConcurrentCacheAdapter *m_cache;
+            LockingCacheAdapter *m_lockingCache;
+            AbstractCacheAdapter *m_defaultCache;
+            QReadWriteLock m_cacheLock;
             EnvironmentRepository *m_environments;
+
+            QThreadPool *m_pool;
+            QThreadStorage<int*> m_lastErrors;
+            QMutex m_cacheMutex;
+            QVector<GiantswarmCachePolicy> m_cachePolicies;
+            QSet<QString> m_revalidating;
+
+            struct Generation {
+                QString value;
+                QElapsedTimer checkedAt;
+            };
+
+            QHash<QString, Generation> m_generations;
+            QMutex m_generationsMutex;
+
+            struct Flight {
+                QWaitCondition done;
+                bool finished;
+                int waiters;
+                int error;
+                GiantswarmResponse response;
+            };
+
+            QHash<QString, Flight*> m_flights;
+            QMutex m_flightsMutex;
         };
 
     };
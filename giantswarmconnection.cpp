@@ -0,0 +1,342 @@
+#include <QDebug>
+
+#include "giantswarmconnection.hpp"
+
+using namespace Bidstack::Giantswarm;
+
+GiantswarmConnection::GiantswarmConnection(const QUrl& url) {
+    m_secure = url.scheme() == "https";
+    m_host = url.host();
+    m_port = url.port(m_secure ? 443 : 80);
+    m_timeout = DEFAULT_REQUEST_TIMEOUT * 1000;
+    m_socket = 0;
+    m_configuration = QSslConfiguration::defaultConfiguration();
+    lastUsed = 0;
+}
+
+GiantswarmConnection::~GiantswarmConnection() {
+    delete m_socket;
+}
+
+QString GiantswarmConnection::origin(const QUrl& url) {
+    bool secure = url.scheme() == "https";
+    return url.scheme() + "://" + url.host() + ":" + QString::number(url.port(secure ? 443 : 80));
+}
+
+/**
+ * A request on a kept-alive connection the server has closed in the
+ * meantime is sent again on a new connection, as long as nothing was
+ * received for it and repeating the method is harmless.
+ */
+bool GiantswarmConnection::send(const QString& method, const QUrl& url, const QMap<QString, QString>& headers, const QByteArray& body, Response *response) {
+    bool reused = isOpen();
+
+    if (reused) {
+        // Lets the socket notice a close or stray bytes from the server.
+        m_socket->waitForReadyRead(0);
+
+        if (m_socket->state() != QAbstractSocket::ConnectedState || m_socket->bytesAvailable() > 0) {
+            reused = false;
+        }
+    }
+
+    if (!reused && !open()) {
+        return false;
+    }
+
+    bool received = false;
+    if (exchange(method, url, headers, body, response, &received)) {
+        return true;
+    }
+
+    bool repeatable = method == "GET" || method == "HEAD" || method == "PUT" || method == "DELETE";
+    if (!reused || received || !repeatable || !open()) {
+        close();
+        return false;
+    }
+
+    if (!exchange(method, url, headers, body, response, &received)) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+bool GiantswarmConnection::isOpen() const {
+    return m_socket && m_socket->state() == QAbstractSocket::ConnectedState;
+}
+
+void GiantswarmConnection::close() {
+    if (m_socket) {
+        m_sessionTicket = sessionTicket();
+        m_socket->abort();
+        delete m_socket;
+        m_socket = 0;
+    }
+}
+
+void GiantswarmConnection::setSslConfiguration(const QSslConfiguration& configuration) {
+    m_configuration = configuration;
+}
+
+/**
+ * Offered when the connection is next established.
+ */
+void GiantswarmConnection::setSessionTicket(const QByteArray& ticket) {
+    m_sessionTicket = ticket;
+}
+
+/**
+ * The ticket the server issued for the current TLS session, or the one
+ * to be offered next if there is no session.
+ */
+QByteArray GiantswarmConnection::sessionTicket() const {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
+    if (m_socket && m_secure) {
+        QByteArray ticket = m_socket->sslConfiguration().sessionTicket();
+        if (!ticket.isEmpty()) {
+            return ticket;
+        }
+    }
+#endif
+
+    return m_sessionTicket;
+}
+
+bool GiantswarmConnection::open() {
+    close();
+
+    m_socket = new QSslSocket();
+
+    if (!m_secure) {
+        m_socket->connectToHost(m_host, m_port);
+
+        if (!m_socket->waitForConnected(m_timeout)) {
+            qWarning() << "Could not connect to" << m_host << ":" << m_socket->errorString();
+            return false;
+        }
+
+        return true;
+    }
+
+    QSslConfiguration configuration = m_configuration;
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
+    configuration.setSslOption(QSsl::SslOptionDisableSessionPersistence, false);
+    if (!m_sessionTicket.isEmpty()) {
+        configuration.setSessionTicket(m_sessionTicket);
+    }
+#endif
+
+    m_socket->setSslConfiguration(configuration);
+    m_socket->connectToHostEncrypted(m_host, m_port);
+
+    if (!m_socket->waitForEncrypted(m_timeout)) {
+        qWarning() << "Could not connect to" << m_host << ":" << m_socket->errorString();
+        return false;
+    }
+
+    return true;
+}
+
+bool GiantswarmConnection::exchange(const QString& method, const QUrl& url, const QMap<QString, QString>& headers, const QByteArray& body, Response *response, bool *received) {
+    QByteArray target = url.toEncoded(QUrl::RemoveScheme | QUrl::RemoveAuthority | QUrl::RemoveFragment);
+    if (target.isEmpty()) {
+        target = "/";
+    }
+
+    QByteArray data = method.toLatin1() + " " + target + " HTTP/1.1\r\n";
+    data += "Host: " + m_host.toUtf8();
+    if (m_port != (m_secure ? 443 : 80)) {
+        data += ":" + QByteArray::number(m_port);
+    }
+    data += "\r\n";
+
+    QMap<QString, QString>::const_iterator it;
+    for (it = headers.constBegin(); it != headers.constEnd(); ++it) {
+        if (it.key().compare("Host", Qt::CaseInsensitive) == 0 || it.key().compare("Content-Length", Qt::CaseInsensitive) == 0) {
+            continue;
+        }
+
+        data += it.key().toUtf8() + ": " + it.value().toUtf8() + "\r\n";
+    }
+
+    if (!body.isEmpty() || method == "POST" || method == "PUT") {
+        data += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+    }
+
+    data += "\r\n";
+    data += body;
+
+    m_socket->write(data);
+    while (m_socket->bytesToWrite() > 0) {
+        if (!m_socket->waitForBytesWritten(m_timeout)) {
+            return false;
+        }
+    }
+
+    QByteArray line;
+    bool keepAlive = true;
+
+    // Interim 1xx responses are skipped.
+    do {
+        if (!readLine(&line)) {
+            return false;
+        }
+
+        *received = true;
+
+        QList<QByteArray> parts = line.split(' ');
+        if (parts.size() < 2 || !parts.at(0).startsWith("HTTP/")) {
+            qWarning() << "Malformed status line from" << m_host << ":" << line;
+            return false;
+        }
+
+        response->status = parts.at(1).toInt();
+        response->headers.clear();
+        keepAlive = parts.at(0) != "HTTP/1.0";
+
+        while (readLine(&line) && !line.isEmpty()) {
+            int separator = line.indexOf(':');
+            if (separator <= 0) {
+                continue;
+            }
+
+            QString name = QString::fromLatin1(line.left(separator).trimmed());
+            QString value = QString::fromUtf8(line.mid(separator + 1).trimmed());
+
+            if (response->headers.contains(name)) {
+                response->headers[name] += ", " + value;
+            } else {
+                response->headers.insert(name, value);
+            }
+        }
+
+        if (!line.isEmpty()) {
+            return false;
+        }
+    } while (response->status >= 100 && response->status < 200);
+
+    QString connection = header(response->headers, "Connection").toLower();
+    if (connection.contains("close")) {
+        keepAlive = false;
+    } else if (connection.contains("keep-alive")) {
+        keepAlive = true;
+    }
+
+    response->body.clear();
+
+    bool hasBody = method != "HEAD" && response->status != 204 && response->status != 304;
+    QString length = header(response->headers, "Content-Length");
+
+    if (!hasBody) {
+        // Nothing to read.
+    } else if (header(response->headers, "Transfer-Encoding").toLower().contains("chunked")) {
+        if (!readChunked(&response->body)) {
+            return false;
+        }
+    } else if (!length.isEmpty()) {
+        if (!readBytes(length.toLongLong(), &response->body)) {
+            return false;
+        }
+    } else {
+        readUntilClosed(&response->body);
+        keepAlive = false;
+    }
+
+    if (!keepAlive) {
+        close();
+    }
+
+    return true;
+}
+
+bool GiantswarmConnection::readLine(QByteArray *line) {
+    while (!m_socket->canReadLine()) {
+        if (!m_socket->waitForReadyRead(m_timeout)) {
+            return false;
+        }
+    }
+
+    *line = m_socket->readLine();
+
+    while (line->endsWith('\n') || line->endsWith('\r')) {
+        line->chop(1);
+    }
+
+    return true;
+}
+
+bool GiantswarmConnection::readBytes(qint64 size, QByteArray *data) {
+    qint64 end = data->size() + size;
+
+    while (data->size() < end) {
+        if (m_socket->bytesAvailable() == 0 && !m_socket->waitForReadyRead(m_timeout)) {
+            return false;
+        }
+
+        data->append(m_socket->read(end - data->size()));
+    }
+
+    return true;
+}
+
+bool GiantswarmConnection::readChunked(QByteArray *data) {
+    QByteArray line;
+
+    forever {
+        if (!readLine(&line)) {
+            return false;
+        }
+
+        bool ok = false;
+        qint64 size = line.split(';').first().trimmed().toLongLong(&ok, 16);
+        if (!ok) {
+            return false;
+        }
+
+        if (size == 0) {
+            break;
+        }
+
+        if (!readBytes(size, data) || !readLine(&line)) {
+            return false;
+        }
+    }
+
+    // Trailers are not used.
+    while (readLine(&line)) {
+        if (line.isEmpty()) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void GiantswarmConnection::readUntilClosed(QByteArray *data) {
+    forever {
+        data->append(m_socket->readAll());
+
+        if (m_socket->state() != QAbstractSocket::ConnectedState || !m_socket->waitForReadyRead(m_timeout)) {
+            break;
+        }
+    }
+
+    data->append(m_socket->readAll());
+}
+
+/**
+ * The value of a response header, looked up case-insensitively.
+ */
+QString GiantswarmConnection::header(const QMap<QString, QString>& headers, const QString& name) {
+    QMap<QString, QString>::const_iterator it;
+    for (it = headers.constBegin(); it != headers.constEnd(); ++it) {
+        if (it.key().compare(name, Qt::CaseInsensitive) == 0) {
+            return it.value();
+        }
+    }
+
+    return QString();
+}
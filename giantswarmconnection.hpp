@@ -0,0 +1,75 @@
+#ifndef BIDSTACK_GIANTSWARM_CONNECTION_HPP
+#define BIDSTACK_GIANTSWARM_CONNECTION_HPP
+
+#include <QByteArray>
+#include <QMap>
+#include <QSslConfiguration>
+#include <QSslSocket>
+#include <QString>
+#include <QUrl>
+
+namespace Bidstack {
+    namespace Giantswarm {
+
+        const int DEFAULT_REQUEST_TIMEOUT = 30;
+
+        /**
+         * A kept-alive HTTP/1.1 connection to one origin, used by a single
+         * thread.
+         *
+         * Requests block in the socket's waitFor*() calls, so neither the
+         * calling thread nor a pool worker needs an event loop and no events
+         * are delivered while a request runs. When the connection has to be
+         * (re)established, the TLS session ticket of an earlier connection
+         * is offered to resume the session instead of a full handshake.
+         */
+        class GiantswarmConnection {
+        public:
+            struct Response {
+                int status;
+                QMap<QString, QString> headers;
+                QByteArray body;
+            };
+
+        public:
+            GiantswarmConnection(const QUrl& url);
+            ~GiantswarmConnection();
+
+        public:
+            static QString origin(const QUrl& url);
+            static QString header(const QMap<QString, QString>& headers, const QString& name);
+
+            bool send(const QString& method, const QUrl& url, const QMap<QString, QString>& headers, const QByteArray& body, Response *response);
+            bool isOpen() const;
+            void close();
+
+            void setSslConfiguration(const QSslConfiguration& configuration);
+            void setSessionTicket(const QByteArray& ticket);
+            QByteArray sessionTicket() const;
+
+            qint64 lastUsed;
+
+        private:
+            bool open();
+            bool exchange(const QString& method, const QUrl& url, const QMap<QString, QString>& headers, const QByteArray& body, Response *response, bool *received);
+
+            bool readLine(QByteArray *line);
+            bool readBytes(qint64 size, QByteArray *data);
+            bool readChunked(QByteArray *data);
+            void readUntilClosed(QByteArray *data);
+
+        private:
+            bool m_secure;
+            QString m_host;
+            quint16 m_port;
+            int m_timeout;
+
+            QSslSocket *m_socket;
+            QSslConfiguration m_configuration;
+            QByteArray m_sessionTicket;
+        };
+
+    };
+};
+
+#endif
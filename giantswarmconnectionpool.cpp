@@ -0,0 +1,160 @@
+#include <QDateTime>
+#include <QMutexLocker>
+
+#include "giantswarmconnectionpool.hpp"
+
+using namespace Bidstack::Giantswarm;
+
+/**
+ * Lease
+ */
+
+GiantswarmConnectionPool::Lease::Lease(GiantswarmConnectionPool *pool, const QString& url) {
+    QUrl parsed(url);
+
+    m_pool = pool;
+    m_origin = GiantswarmConnection::origin(parsed);
+    m_connection = m_pool->acquire(parsed, m_origin);
+}
+
+GiantswarmConnectionPool::Lease::~Lease() {
+    m_pool->release(m_origin, m_connection);
+}
+
+GiantswarmConnection* GiantswarmConnectionPool::Lease::connection() const {
+    return m_connection;
+}
+
+/**
+ * Connections
+ */
+
+GiantswarmConnectionPool::Connections::~Connections() {
+    qDeleteAll(byOrigin);
+}
+
+/**
+ * Pool
+ */
+
+GiantswarmConnectionPool::GiantswarmConnectionPool() {
+    m_maxConcurrentRequestsPerHost = DEFAULT_MAX_CONCURRENT_REQUESTS_PER_HOST;
+    m_idleTimeout = DEFAULT_CONNECTION_IDLE_TIMEOUT;
+    m_sslConfiguration = QSslConfiguration::defaultConfiguration();
+}
+
+GiantswarmConnectionPool::~GiantswarmConnectionPool() {
+    // Connections of other threads are released when those threads exit;
+    // the ones of the destroying thread have to go now.
+    if (m_connections.hasLocalData()) {
+        m_connections.setLocalData(0);
+    }
+}
+
+void GiantswarmConnectionPool::setMaxConcurrentRequestsPerHost(int count) {
+    QMutexLocker locker(&m_mutex);
+    m_maxConcurrentRequestsPerHost = qMax(1, count);
+    m_available.wakeAll();
+}
+
+int GiantswarmConnectionPool::maxConcurrentRequestsPerHost() {
+    QMutexLocker locker(&m_mutex);
+    return m_maxConcurrentRequestsPerHost;
+}
+
+/**
+ * 0 keeps idle connections open until the server closes them.
+ */
+void GiantswarmConnectionPool::setIdleTimeout(int seconds) {
+    QMutexLocker locker(&m_mutex);
+    m_idleTimeout = qMax(0, seconds);
+}
+
+int GiantswarmConnectionPool::idleTimeout() {
+    QMutexLocker locker(&m_mutex);
+    return m_idleTimeout;
+}
+
+/**
+ * Applies to connections established from now on, e.g. to trust an
+ * additional CA certificate.
+ */
+void GiantswarmConnectionPool::setSslConfiguration(const QSslConfiguration& configuration) {
+    QMutexLocker locker(&m_mutex);
+    m_sslConfiguration = configuration;
+}
+
+QSslConfiguration GiantswarmConnectionPool::sslConfiguration() {
+    QMutexLocker locker(&m_mutex);
+    return m_sslConfiguration;
+}
+
+/**
+ * The TLS session ticket new connections to the origin of the URL offer,
+ * empty if there is none yet.
+ */
+QByteArray GiantswarmConnectionPool::sessionTicket(const QString& url) {
+    QMutexLocker locker(&m_mutex);
+    return m_sessionTickets.value(GiantswarmConnection::origin(QUrl(url)));
+}
+
+GiantswarmConnection* GiantswarmConnectionPool::acquire(const QUrl& url, const QString& origin) {
+    QMutexLocker locker(&m_mutex);
+
+    while (m_active.value(origin, 0) >= m_maxConcurrentRequestsPerHost) {
+        m_available.wait(&m_mutex);
+    }
+
+    m_active[origin] += 1;
+
+    qint64 idleTimeout = (qint64) m_idleTimeout * 1000;
+    QSslConfiguration configuration = m_sslConfiguration;
+    QByteArray ticket = m_sessionTickets.value(origin);
+
+    locker.unlock();
+
+    if (!m_connections.hasLocalData()) {
+        m_connections.setLocalData(new Connections());
+    }
+
+    Connections *connections = m_connections.localData();
+    GiantswarmConnection *connection = connections->byOrigin.value(origin, 0);
+
+    if (!connection) {
+        connection = new GiantswarmConnection(url);
+        connections->byOrigin.insert(origin, connection);
+    }
+
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    if (idleTimeout > 0 && connection->isOpen() && now - connection->lastUsed > idleTimeout) {
+        connection->close();
+    }
+
+    // Only used when the connection has to be established.
+    connection->setSslConfiguration(configuration);
+    if (!ticket.isEmpty()) {
+        connection->setSessionTicket(ticket);
+    }
+
+    connection->lastUsed = now;
+
+    return connection;
+}
+
+void GiantswarmConnectionPool::release(const QString& origin, GiantswarmConnection *connection) {
+    connection->lastUsed = QDateTime::currentMSecsSinceEpoch();
+    QByteArray ticket = connection->sessionTicket();
+
+    QMutexLocker locker(&m_mutex);
+
+    if (!ticket.isEmpty()) {
+        m_sessionTickets.insert(origin, ticket);
+    }
+
+    if (--m_active[origin] <= 0) {
+        m_active.remove(origin);
+    }
+
+    m_available.wakeAll();
+}
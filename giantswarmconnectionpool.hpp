@@ -0,0 +1,100 @@
+#ifndef BIDSTACK_GIANTSWARM_CONNECTIONPOOL_HPP
+#define BIDSTACK_GIANTSWARM_CONNECTIONPOOL_HPP
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QSslConfiguration>
+#include <QString>
+#include <QThreadStorage>
+#include <QUrl>
+#include <QWaitCondition>
+
+#include "giantswarmconnection.hpp"
+
+namespace Bidstack {
+    namespace Giantswarm {
+
+        const int DEFAULT_MAX_CONCURRENT_REQUESTS_PER_HOST = 6;
+        const int DEFAULT_CONNECTION_IDLE_TIMEOUT = 30;
+
+        /**
+         * Hands out connections for API requests.
+         *
+         * Every thread keeps one connection per origin, as sockets are bound
+         * to the thread they were created in, and reuses it for subsequent
+         * requests so they skip connection setup. A connection that has been
+         * idle for longer than the idle timeout is re-established instead of
+         * reusing one the server has likely closed already; an idle timeout
+         * of 0 keeps connections for as long as the server does.
+         *
+         * The latest TLS session ticket of each origin is shared by all
+         * threads and offered by every new connection, which lets servers
+         * supporting tickets skip the full handshake. The number of requests
+         * running against one origin at the same time is capped across all
+         * threads; the number of open sockets is not, as every thread keeps
+         * its own idle one.
+         */
+        class GiantswarmConnectionPool {
+        public:
+            class Lease;
+            friend class Lease;
+
+            class Lease {
+            public:
+                Lease(GiantswarmConnectionPool *pool, const QString& url);
+                ~Lease();
+
+            public:
+                GiantswarmConnection* connection() const;
+
+            private:
+                GiantswarmConnectionPool *m_pool;
+                QString m_origin;
+                GiantswarmConnection *m_connection;
+            };
+
+        public:
+            GiantswarmConnectionPool();
+            ~GiantswarmConnectionPool();
+
+        public:
+            void setMaxConcurrentRequestsPerHost(int count);
+            int maxConcurrentRequestsPerHost();
+
+            void setIdleTimeout(int seconds);
+            int idleTimeout();
+
+            void setSslConfiguration(const QSslConfiguration& configuration);
+            QSslConfiguration sslConfiguration();
+
+            QByteArray sessionTicket(const QString& url);
+
+        private:
+            GiantswarmConnection* acquire(const QUrl& url, const QString& origin);
+            void release(const QString& origin, GiantswarmConnection *connection);
+
+        private:
+            class Connections {
+            public:
+                ~Connections();
+
+            public:
+                QHash<QString, GiantswarmConnection*> byOrigin;
+            };
+
+            QThreadStorage<Connections*> m_connections;
+
+            QMutex m_mutex;
+            QWaitCondition m_available;
+            QHash<QString, int> m_active;
+            QHash<QString, QByteArray> m_sessionTickets;
+            QSslConfiguration m_sslConfiguration;
+            int m_maxConcurrentRequestsPerHost;
+            int m_idleTimeout;
+        };
+
+    };
+};
+
+#endif
@@ -0,0 +1,101 @@
+#include "giantswarmendpoint.hpp"
+
+using namespace Bidstack::Giantswarm;
+
+QString GiantswarmEndpoint::name(Endpoint endpoint) {
+    switch (endpoint) {
+        case Login:
+          return "login";
+
+        case Logout:
+          return "logout";
+
+        case Companies:
+          return "companies";
+
+        case CreateCompany:
+          return "create_company";
+
+        case DeleteCompany:
+          return "delete_company";
+
+        case CompanyUsers:
+          return "company_users";
+
+        case AddUserToCompany:
+          return "add_user_to_company";
+
+        case RemoveUserFromCompany:
+          return "remove_user_from_company";
+
+        case Applications:
+          return "applications";
+
+        case ApplicationStatus:
+          return "application_status";
+
+        case StartApplication:
+          return "start_application";
+
+        case StopApplication:
+          return "stop_application";
+
+        case ScaleApplication:
+          return "scale_application";
+
+        case InstanceStatistics:
+          return "instance_statistics";
+
+        case User:
+          return "user";
+
+        case UpdateEmail:
+          return "update_email";
+
+        case UpdatePassword:
+          return "update_password";
+
+        case Ping:
+          return "ping";
+    }
+
+    return QString();
+}
+
+GiantswarmEndpoint::Idempotency GiantswarmEndpoint::idempotency(Endpoint endpoint) {
+    switch (endpoint) {
+        case Companies:
+        case CompanyUsers:
+        case Applications:
+        case ApplicationStatus:
+        case InstanceStatistics:
+        case User:
+        case Ping:
+          return Safe;
+
+        case Logout:
+        case DeleteCompany:
+        case AddUserToCompany:
+        case RemoveUserFromCompany:
+        case StartApplication:
+        case StopApplication:
+        case UpdatePassword:
+          return Idempotent;
+
+        case Login:
+        case CreateCompany:
+        case ScaleApplication:
+        case UpdateEmail:
+          return NonIdempotent;
+    }
+
+    return NonIdempotent;
+}
+
+GiantswarmEndpoint::Category GiantswarmEndpoint::category(Endpoint endpoint) {
+    if (endpoint == InstanceStatistics) {
+        return Statistics;
+    }
+
+    return idempotency(endpoint) == Safe ? Status : Mutation;
+}
@@ -0,0 +1,68 @@
+#ifndef BIDSTACK_GIANTSWARM_ENDPOINT_HPP
+#define BIDSTACK_GIANTSWARM_ENDPOINT_HPP
+
+#include <QString>
+
+namespace Bidstack {
+    namespace Giantswarm {
+
+        class GiantswarmEndpoint {
+        public:
+            enum Endpoint {
+                Login = 0,
+                Logout = 1,
+                Companies = 2,
+                CreateCompany = 3,
+                DeleteCompany = 4,
+                CompanyUsers = 5,
+                AddUserToCompany = 6,
+                RemoveUserFromCompany = 7,
+                Applications = 8,
+                ApplicationStatus = 9,
+                StartApplication = 10,
+                StopApplication = 11,
+                ScaleApplication = 12,
+                InstanceStatistics = 13,
+                User = 14,
+                UpdateEmail = 15,
+                UpdatePassword = 16,
+                Ping = 17
+            };
+
+            static const int Count = Ping + 1;
+
+            /**
+             * Whether repeating a request can change its outcome: Safe
+             * requests only read, Idempotent ones have the same effect no
+             * matter how often they are sent, NonIdempotent ones do not.
+             */
+            enum Idempotency {
+                Safe = 0,
+                Idempotent = 1,
+                NonIdempotent = 2
+            };
+
+            static const int IdempotencyCount = NonIdempotent + 1;
+
+            /**
+             * Coarse grouping used to limit and prioritize requests: instance
+             * statistics, every other read, and everything that changes state.
+             */
+            enum Category {
+                Status = 0,
+                Statistics = 1,
+                Mutation = 2
+            };
+
+            static const int CategoryCount = Mutation + 1;
+
+        public:
+            static QString name(Endpoint endpoint);
+            static Idempotency idempotency(Endpoint endpoint);
+            static Category category(Endpoint endpoint);
+        };
+
+    };
+};
+
+#endif
@@ -38,6 +38,12 @@ QString GiantswarmError::errorString() const {
 
         case ResponseStatusMismatch:
           return "Received status_code does not match expected status!";
+
+        case InvalidCacheEntry:
+          return "Received invalid entry from cache!";
+
+        case InvocationFailed:
+          return "Could not invoke client method!";
     }
 
     return QString();
@@ -17,7 +17,9 @@ namespace Bidstack {
                 UnexpectedResponseStatus = 7,
                 LoginRequired = 8,
                 LogoutRequired = 9,
-                ResponseStatusMismatch = 10
+                ResponseStatusMismatch = 10,
+                InvalidCacheEntry = 11,
+                InvocationFailed = 12
             };
 
         public:
@@ -0,0 +1,271 @@
+#include <QMutexLocker>
+
+#include "giantswarmgovernor.hpp"
+
+using namespace Bidstack::Giantswarm;
+
+/**
+ * Lease
+ */
+
+GiantswarmGovernor::Lease::Lease(GiantswarmGovernor *governor, GiantswarmEndpoint::Endpoint endpoint, const QString& company) {
+    m_governor = governor;
+    m_buckets = m_governor->acquire(endpoint, company);
+}
+
+GiantswarmGovernor::Lease::~Lease() {
+    if (!m_buckets.isEmpty()) {
+        m_governor->release(m_buckets);
+    }
+}
+
+/**
+ * Bucket
+ */
+
+GiantswarmGovernor::Bucket::Bucket() {
+    tokens = 0;
+    updatedAt = 0;
+    inFlight = 0;
+}
+
+void GiantswarmGovernor::Bucket::setLimit(const GiantswarmRateLimit& limit, qint64 now) {
+    if (this->limit.rate() > 0) {
+        refill(now);
+        tokens = qMin(tokens, (double) limit.burst());
+    } else {
+        tokens = limit.burst();
+    }
+
+    this->limit = limit;
+    updatedAt = now;
+}
+
+void GiantswarmGovernor::Bucket::refill(qint64 now) {
+    if (limit.rate() > 0) {
+        tokens = qMin((double) limit.burst(), tokens + (now - updatedAt) * limit.rate() / 1000.0);
+    }
+
+    updatedAt = now;
+}
+
+bool GiantswarmGovernor::Bucket::hasCapacity() const {
+    if (limit.maxInFlight() > 0 && inFlight >= limit.maxInFlight()) {
+        return false;
+    }
+
+    return limit.rate() <= 0 || tokens >= 1.0;
+}
+
+/**
+ * Milliseconds until the bucket holds a whole token again, or 0 if it
+ * already does or has no rate.
+ */
+qint64 GiantswarmGovernor::Bucket::timeUntilToken() const {
+    if (limit.rate() <= 0 || tokens >= 1.0) {
+        return 0;
+    }
+
+    return (qint64) ((1.0 - tokens) * 1000.0 / limit.rate()) + 1;
+}
+
+/**
+ * Governor
+ */
+
+GiantswarmGovernor::GiantswarmGovernor() {
+    m_clock.start();
+
+    m_priorities[GiantswarmEndpoint::Status] = Normal;
+    m_priorities[GiantswarmEndpoint::Statistics] = Background;
+    m_priorities[GiantswarmEndpoint::Mutation] = Interactive;
+}
+
+GiantswarmGovernor::~GiantswarmGovernor() {
+    qDeleteAll(m_companies);
+}
+
+void GiantswarmGovernor::setGlobalLimit(const GiantswarmRateLimit& limit) {
+    QMutexLocker locker(&m_mutex);
+    m_global.setLimit(limit, m_clock.elapsed());
+    m_changed.wakeAll();
+}
+
+/**
+ * Sets the limit each company gets unless it has one of its own.
+ */
+void GiantswarmGovernor::setCompanyLimit(const GiantswarmRateLimit& limit) {
+    QMutexLocker locker(&m_mutex);
+    m_companyLimit = limit;
+
+    qint64 now = m_clock.elapsed();
+    QHash<QString, Bucket*>::const_iterator it;
+    for (it = m_companies.constBegin(); it != m_companies.constEnd(); ++it) {
+        if (!m_companyLimits.contains(it.key())) {
+            it.value()->setLimit(limit, now);
+        }
+    }
+
+    m_changed.wakeAll();
+}
+
+void GiantswarmGovernor::setCompanyLimit(const QString& company, const GiantswarmRateLimit& limit) {
+    QMutexLocker locker(&m_mutex);
+    m_companyLimits.insert(company, limit);
+
+    Bucket *bucket = m_companies.value(company, 0);
+    if (bucket) {
+        bucket->setLimit(limit, m_clock.elapsed());
+    }
+
+    m_changed.wakeAll();
+}
+
+void GiantswarmGovernor::setCategoryLimit(GiantswarmEndpoint::Category category, const GiantswarmRateLimit& limit) {
+    QMutexLocker locker(&m_mutex);
+    m_categories[category].setLimit(limit, m_clock.elapsed());
+    m_changed.wakeAll();
+}
+
+/**
+ * By default mutations are Interactive, instance statistics Background
+ * and all other reads Normal.
+ */
+void GiantswarmGovernor::setPriority(GiantswarmEndpoint::Category category, Priority priority) {
+    QMutexLocker locker(&m_mutex);
+    m_priorities[category] = priority;
+}
+
+GiantswarmGovernor::Priority GiantswarmGovernor::priority(GiantswarmEndpoint::Endpoint endpoint) {
+    QMutexLocker locker(&m_mutex);
+    return m_priorities[GiantswarmEndpoint::category(endpoint)];
+}
+
+QList<GiantswarmGovernor::Bucket*> GiantswarmGovernor::acquire(GiantswarmEndpoint::Endpoint endpoint, const QString& company) {
+    QMutexLocker locker(&m_mutex);
+
+    Waiter waiter;
+    waiter.priority = m_priorities[GiantswarmEndpoint::category(endpoint)];
+    waiter.buckets = buckets(endpoint, company);
+
+    if (waiter.buckets.isEmpty()) {
+        return waiter.buckets;
+    }
+
+    int position = 0;
+    while (position < m_waiting.size() && m_waiting.at(position)->priority >= waiter.priority) {
+        ++position;
+    }
+
+    m_waiting.insert(position, &waiter);
+
+    forever {
+        bool admitted = !isOvertaking(&waiter);
+        qint64 wait = 0;
+        qint64 now = m_clock.elapsed();
+
+        if (admitted) {
+            foreach (Bucket *bucket, waiter.buckets) {
+                bucket->refill(now);
+
+                if (!bucket->hasCapacity()) {
+                    admitted = false;
+                    wait = qMax(wait, bucket->timeUntilToken());
+                }
+            }
+        }
+
+        if (admitted) {
+            break;
+        }
+
+        // Without a token to wait for, only a release or a request ahead
+        // being admitted can change anything, and both wake us.
+        if (wait > 0) {
+            m_changed.wait(&m_mutex, (unsigned long) wait);
+        } else {
+            m_changed.wait(&m_mutex);
+        }
+    }
+
+    foreach (Bucket *bucket, waiter.buckets) {
+        if (bucket->limit.rate() > 0) {
+            bucket->tokens -= 1.0;
+        }
+
+        ++bucket->inFlight;
+    }
+
+    m_waiting.removeOne(&waiter);
+    m_changed.wakeAll();
+
+    return waiter.buckets;
+}
+
+void GiantswarmGovernor::release(const QList<Bucket*>& buckets) {
+    QMutexLocker locker(&m_mutex);
+
+    foreach (Bucket *bucket, buckets) {
+        --bucket->inFlight;
+    }
+
+    m_changed.wakeAll();
+}
+
+/**
+ * The buckets with a limit that apply to a request. Requests without a
+ * company, like those for the current user, only count globally and in
+ * their category.
+ */
+QList<GiantswarmGovernor::Bucket*> GiantswarmGovernor::buckets(GiantswarmEndpoint::Endpoint endpoint, const QString& company) {
+    QList<Bucket*> result;
+
+    if (!m_global.limit.isUnlimited()) {
+        result.append(&m_global);
+    }
+
+    if (!company.isEmpty()) {
+        Bucket *bucket = m_companies.value(company, 0);
+
+        if (!bucket) {
+            GiantswarmRateLimit limit = m_companyLimits.value(company, m_companyLimit);
+
+            if (!limit.isUnlimited()) {
+                bucket = new Bucket();
+                bucket->setLimit(limit, m_clock.elapsed());
+                m_companies.insert(company, bucket);
+            }
+        }
+
+        if (bucket && !bucket->limit.isUnlimited()) {
+            result.append(bucket);
+        }
+    }
+
+    Bucket *category = &m_categories[GiantswarmEndpoint::category(endpoint)];
+    if (!category->limit.isUnlimited()) {
+        result.append(category);
+    }
+
+    return result;
+}
+
+/**
+ * Whether admitting the waiter now would take capacity a request queued
+ * ahead of it is waiting for.
+ */
+bool GiantswarmGovernor::isOvertaking(const Waiter *waiter) const {
+    foreach (const Waiter *ahead, m_waiting) {
+        if (ahead == waiter) {
+            return false;
+        }
+
+        foreach (Bucket *bucket, ahead->buckets) {
+            if (waiter->buckets.contains(bucket)) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
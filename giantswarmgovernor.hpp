@@ -0,0 +1,117 @@
+#ifndef BIDSTACK_GIANTSWARM_GOVERNOR_HPP
+#define BIDSTACK_GIANTSWARM_GOVERNOR_HPP
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QWaitCondition>
+
+#include "giantswarmendpoint.hpp"
+#include "giantswarmratelimit.hpp"
+
+namespace Bidstack {
+    namespace Giantswarm {
+
+        /**
+         * Admits API requests according to rate limits for the whole client,
+         * for each company and for each endpoint category.
+         *
+         * Every limit is a token bucket plus a cap on requests in flight. A
+         * request that cannot start yet waits in a queue ordered by priority,
+         * then arrival; it does not overtake a request ahead of it that waits
+         * for one of the same limits. Requests without a limit in common do
+         * not hold each other up.
+         */
+        class GiantswarmGovernor {
+        public:
+            enum Priority {
+                Background = 0,
+                Normal = 1,
+                Interactive = 2
+            };
+
+        private:
+            class Bucket;
+
+        public:
+            class Lease;
+            friend class Lease;
+
+            /**
+             * Waits for admission on construction and frees the request's
+             * in-flight slots on destruction.
+             */
+            class Lease {
+            public:
+                Lease(GiantswarmGovernor *governor, GiantswarmEndpoint::Endpoint endpoint, const QString& company);
+                ~Lease();
+
+            private:
+                GiantswarmGovernor *m_governor;
+                QList<Bucket*> m_buckets;
+            };
+
+        public:
+            GiantswarmGovernor();
+            ~GiantswarmGovernor();
+
+        public:
+            void setGlobalLimit(const GiantswarmRateLimit& limit);
+            void setCompanyLimit(const GiantswarmRateLimit& limit);
+            void setCompanyLimit(const QString& company, const GiantswarmRateLimit& limit);
+            void setCategoryLimit(GiantswarmEndpoint::Category category, const GiantswarmRateLimit& limit);
+
+            void setPriority(GiantswarmEndpoint::Category category, Priority priority);
+            Priority priority(GiantswarmEndpoint::Endpoint endpoint);
+
+        private:
+            QList<Bucket*> acquire(GiantswarmEndpoint::Endpoint endpoint, const QString& company);
+            void release(const QList<Bucket*>& buckets);
+
+            QList<Bucket*> buckets(GiantswarmEndpoint::Endpoint endpoint, const QString& company);
+
+        private:
+            class Bucket {
+            public:
+                Bucket();
+
+            public:
+                void setLimit(const GiantswarmRateLimit& limit, qint64 now);
+                void refill(qint64 now);
+                bool hasCapacity() const;
+                qint64 timeUntilToken() const;
+
+            public:
+                GiantswarmRateLimit limit;
+                double tokens;
+                qint64 updatedAt;
+                int inFlight;
+            };
+
+            struct Waiter {
+                Priority priority;
+                QList<Bucket*> buckets;
+            };
+
+            bool isOvertaking(const Waiter *waiter) const;
+
+            QMutex m_mutex;
+            QWaitCondition m_changed;
+            QElapsedTimer m_clock;
+            QList<Waiter*> m_waiting;
+
+            Bucket m_global;
+            Bucket m_categories[GiantswarmEndpoint::CategoryCount];
+            Priority m_priorities[GiantswarmEndpoint::CategoryCount];
+
+            GiantswarmRateLimit m_companyLimit;
+            QHash<QString, GiantswarmRateLimit> m_companyLimits;
+            QHash<QString, Bucket*> m_companies;
+        };
+
+    };
+};
+
+#endif
@@ -0,0 +1,309 @@
+#include <cstdlib>
+#include <cstring>
+
+#include "giantswarmjsonreader.hpp"
+
+using namespace Bidstack::Giantswarm;
+
+GiantswarmJsonReader::GiantswarmJsonReader(const QByteArray& data) {
+    // Holding a copy keeps the implicitly shared bytes alive while the
+    // raw pointers below are in use.
+    m_data = data;
+    m_begin = m_data.constData();
+    m_end = m_begin + m_data.size();
+    m_pos = m_begin;
+
+    m_token = Invalid;
+    m_expectName = false;
+    m_error = false;
+    m_number = 0;
+    m_boolean = false;
+}
+
+GiantswarmJsonReader::Token GiantswarmJsonReader::next() {
+    if (m_error) {
+        return Invalid;
+    }
+
+    skipWhitespace();
+
+    if (m_pos < m_end && (*m_pos == ',' || *m_pos == ':')) {
+        if (*m_pos == ',' && !m_stack.isEmpty() && m_stack.last() == '{') {
+            m_expectName = true;
+        }
+
+        ++m_pos;
+        skipWhitespace();
+    }
+
+    if (m_pos >= m_end) {
+        if (!m_stack.isEmpty()) {
+            return fail();
+        }
+
+        m_token = EndOfDocument;
+        return m_token;
+    }
+
+    switch (*m_pos) {
+        case '{':
+          ++m_pos;
+          m_stack.append('{');
+          m_expectName = true;
+          m_token = BeginObject;
+          break;
+
+        case '[':
+          ++m_pos;
+          m_stack.append('[');
+          m_expectName = false;
+          m_token = BeginArray;
+          break;
+
+        case '}':
+        case ']': {
+          char open = *m_pos == '}' ? '{' : '[';
+          if (m_stack.isEmpty() || m_stack.last() != open) {
+              return fail();
+          }
+
+          ++m_pos;
+          m_stack.pop_back();
+          m_expectName = false;
+          m_token = open == '{' ? EndObject : EndArray;
+          break;
+        }
+
+        case '"':
+          if (!readString()) {
+              return fail();
+          }
+
+          if (m_expectName) {
+              m_expectName = false;
+              m_token = Name;
+          } else {
+              m_token = String;
+          }
+          break;
+
+        case 't':
+          if (!readLiteral("true")) {
+              return fail();
+          }
+          m_boolean = true;
+          m_token = Bool;
+          break;
+
+        case 'f':
+          if (!readLiteral("false")) {
+              return fail();
+          }
+          m_boolean = false;
+          m_token = Bool;
+          break;
+
+        case 'n':
+          if (!readLiteral("null")) {
+              return fail();
+          }
+          m_token = Null;
+          break;
+
+        default:
+          if (!readNumber()) {
+              return fail();
+          }
+          m_token = Number;
+          break;
+    }
+
+    return m_token;
+}
+
+GiantswarmJsonReader::Token GiantswarmJsonReader::token() const {
+    return m_token;
+}
+
+bool GiantswarmJsonReader::hasError() const {
+    return m_error;
+}
+
+QString GiantswarmJsonReader::string() const {
+    return m_string;
+}
+
+double GiantswarmJsonReader::number() const {
+    return m_number;
+}
+
+bool GiantswarmJsonReader::boolean() const {
+    return m_boolean;
+}
+
+/**
+ * Returns the current value if it is a string, and an empty string for
+ * any other value, which is skipped.
+ */
+QString GiantswarmJsonReader::stringValue() {
+    if (m_token == String) {
+        return m_string;
+    }
+
+    skip();
+    return QString();
+}
+
+/**
+ * Returns the current value if it is a number, and 0 for any other
+ * value, which is skipped.
+ */
+double GiantswarmJsonReader::numberValue() {
+    if (m_token == Number) {
+        return m_number;
+    }
+
+    skip();
+    return 0;
+}
+
+/**
+ * Skips the value starting at the current token. Afterwards the reader
+ * is positioned on its last token.
+ */
+bool GiantswarmJsonReader::skip() {
+    if (m_token != BeginObject && m_token != BeginArray) {
+        return !m_error;
+    }
+
+    int depth = m_stack.size();
+    while (m_stack.size() >= depth) {
+        if (next() == Invalid) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+GiantswarmJsonReader::Token GiantswarmJsonReader::fail() {
+    m_error = true;
+    m_token = Invalid;
+    return m_token;
+}
+
+void GiantswarmJsonReader::skipWhitespace() {
+    while (m_pos < m_end && (*m_pos == ' ' || *m_pos == '\t' || *m_pos == '\n' || *m_pos == '\r')) {
+        ++m_pos;
+    }
+}
+
+bool GiantswarmJsonReader::readString() {
+    const char *start = ++m_pos;
+
+    // Strings without escapes, which is nearly all of them, are decoded
+    // in one go.
+    while (m_pos < m_end && *m_pos != '"' && *m_pos != '\\') {
+        ++m_pos;
+    }
+
+    if (m_pos >= m_end) {
+        return false;
+    }
+
+    if (*m_pos == '"') {
+        m_string = QString::fromUtf8(start, m_pos - start);
+        ++m_pos;
+        return true;
+    }
+
+    QByteArray utf8(start, m_pos - start);
+    QString result;
+
+    while (m_pos < m_end && *m_pos != '"') {
+        if (*m_pos != '\\') {
+            utf8.append(*m_pos++);
+            continue;
+        }
+
+        if (++m_pos >= m_end) {
+            return false;
+        }
+
+        char escape = *m_pos++;
+        switch (escape) {
+            case '"': utf8.append('"'); break;
+            case '\\': utf8.append('\\'); break;
+            case '/': utf8.append('/'); break;
+            case 'b': utf8.append('\b'); break;
+            case 'f': utf8.append('\f'); break;
+            case 'n': utf8.append('\n'); break;
+            case 'r': utf8.append('\r'); break;
+            case 't': utf8.append('\t'); break;
+
+            case 'u': {
+              uint code;
+              if (!readHex(&code)) {
+                  return false;
+              }
+
+              result += QString::fromUtf8(utf8);
+              utf8.clear();
+
+              // Characters outside the BMP arrive as a surrogate pair of
+              // two escapes; QString stores them the same way.
+              result += QChar((ushort) code);
+              break;
+            }
+
+            default:
+              return false;
+        }
+    }
+
+    if (m_pos >= m_end) {
+        return false;
+    }
+
+    ++m_pos;
+    m_string = result + QString::fromUtf8(utf8);
+    return true;
+}
+
+bool GiantswarmJsonReader::readNumber() {
+    const char *start = m_pos;
+
+    while (m_pos < m_end && ((*m_pos != '\0' && strchr("+-.eE", *m_pos)) || (*m_pos >= '0' && *m_pos <= '9'))) {
+        ++m_pos;
+    }
+
+    if (m_pos == start) {
+        return false;
+    }
+
+    bool ok = false;
+    m_number = QByteArray::fromRawData(start, m_pos - start).toDouble(&ok);
+    return ok;
+}
+
+bool GiantswarmJsonReader::readLiteral(const char *literal) {
+    int length = strlen(literal);
+
+    if (m_end - m_pos < length || strncmp(m_pos, literal, length) != 0) {
+        return false;
+    }
+
+    m_pos += length;
+    return true;
+}
+
+bool GiantswarmJsonReader::readHex(uint *value) {
+    if (m_end - m_pos < 4) {
+        return false;
+    }
+
+    bool ok = false;
+    *value = QByteArray(m_pos, 4).toUInt(&ok, 16);
+    m_pos += 4;
+    return ok;
+}
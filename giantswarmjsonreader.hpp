@@ -0,0 +1,79 @@
+#ifndef BIDSTACK_GIANTSWARM_JSONREADER_HPP
+#define BIDSTACK_GIANTSWARM_JSONREADER_HPP
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+namespace Bidstack {
+    namespace Giantswarm {
+
+        /**
+         * Pull parser reading JSON tokens straight from a response body.
+         * Nothing but the strings and numbers asked for is allocated, so
+         * results can be decoded without building a QJsonDocument first.
+         *
+         * next() advances to the next token. When positioned on the first
+         * token of a value, stringValue(), numberValue() and skip() consume
+         * the whole value, including nested objects and arrays.
+         */
+        class GiantswarmJsonReader {
+        public:
+            enum Token {
+                Invalid = 0,
+                BeginObject,
+                EndObject,
+                BeginArray,
+                EndArray,
+                Name,
+                String,
+                Number,
+                Bool,
+                Null,
+                EndOfDocument
+            };
+
+        public:
+            GiantswarmJsonReader(const QByteArray& data);
+
+        public:
+            Token next();
+            Token token() const;
+            bool hasError() const;
+
+            QString string() const;
+            double number() const;
+            bool boolean() const;
+
+            QString stringValue();
+            double numberValue();
+            bool skip();
+
+        private:
+            Token fail();
+            void skipWhitespace();
+            bool readString();
+            bool readNumber();
+            bool readLiteral(const char *literal);
+            bool readHex(uint *value);
+
+        private:
+            QByteArray m_data;
+            const char *m_begin;
+            const char *m_end;
+            const char *m_pos;
+
+            Token m_token;
+            QVector<char> m_stack;
+            bool m_expectName;
+            bool m_error;
+
+            QString m_string;
+            double m_number;
+            bool m_boolean;
+        };
+
+    };
+};
+
+#endif
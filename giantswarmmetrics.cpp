@@ -0,0 +1,290 @@
+#include <QMutexLocker>
+#include <QStringList>
+#include <QTextStream>
+#include <QVariantList>
+
+#include "giantswarmmetrics.hpp"
+
+using namespace Bidstack::Giantswarm;
+
+/**
+ * Timer
+ */
+
+GiantswarmMetrics::Timer::Timer(GiantswarmMetrics *metrics, GiantswarmEndpoint::Endpoint endpoint, Phase phase) {
+    m_metrics = metrics;
+    m_endpoint = endpoint;
+    m_phase = phase;
+    m_timer.start();
+}
+
+GiantswarmMetrics::Timer::~Timer() {
+    m_metrics->recordLatency(m_endpoint, m_phase, m_timer.nsecsElapsed() / 1000);
+}
+
+/**
+ * Metrics
+ */
+
+GiantswarmMetrics::GiantswarmMetrics() {
+    m_endpoints.fill(emptySnapshot(), GiantswarmEndpoint::Count);
+}
+
+/**
+ * Upper bounds of the latency buckets in microseconds, from 1ms to 10s.
+ * Every histogram has one additional bucket for slower samples.
+ */
+QVector<qint64> GiantswarmMetrics::bucketBoundsUs() {
+    static const qint64 bounds[] = {
+        1000, 2500, 5000, 10000, 25000, 50000, 100000,
+        250000, 500000, 1000000, 2500000, 5000000, 10000000
+    };
+
+    QVector<qint64> result;
+    for (unsigned int i = 0; i < sizeof(bounds) / sizeof(bounds[0]); ++i) {
+        result.append(bounds[i]);
+    }
+    return result;
+}
+
+void GiantswarmMetrics::recordRequest(GiantswarmEndpoint::Endpoint endpoint, qint64 bytesOut, qint64 bytesIn) {
+    QMutexLocker locker(&m_mutex);
+    Snapshot& metrics = m_endpoints[endpoint];
+    metrics.requests += 1;
+    metrics.bytesOut += bytesOut;
+    metrics.bytesIn += bytesIn;
+}
+
+void GiantswarmMetrics::recordError(GiantswarmEndpoint::Endpoint endpoint, GiantswarmError::Error error) {
+    QMutexLocker locker(&m_mutex);
+    m_endpoints[endpoint].errors[error] += 1;
+}
+
+void GiantswarmMetrics::recordCacheHit(GiantswarmEndpoint::Endpoint endpoint) {
+    QMutexLocker locker(&m_mutex);
+    m_endpoints[endpoint].cacheHits += 1;
+}
+
+void GiantswarmMetrics::recordCacheMiss(GiantswarmEndpoint::Endpoint endpoint) {
+    QMutexLocker locker(&m_mutex);
+    m_endpoints[endpoint].cacheMisses += 1;
+}
+
+void GiantswarmMetrics::recordLatency(GiantswarmEndpoint::Endpoint endpoint, Phase phase, qint64 us) {
+    static const QVector<qint64> bounds = bucketBoundsUs();
+
+    int bucket = 0;
+    while (bucket < bounds.size() && us > bounds.at(bucket)) {
+        ++bucket;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    Histogram& histogram = m_endpoints[endpoint].latency[phase];
+    histogram.buckets[bucket] += 1;
+    histogram.count += 1;
+    histogram.sumUs += us;
+}
+
+GiantswarmMetrics::Snapshot GiantswarmMetrics::snapshot(GiantswarmEndpoint::Endpoint endpoint) {
+    QMutexLocker locker(&m_mutex);
+    return m_endpoints.at(endpoint);
+}
+
+/**
+ * Example:
+ *
+ *   {
+ *     "application_status": {
+ *       "requests": 12, "cache_hits": 30, "cache_misses": 12,
+ *       "bytes_in": 48211, "bytes_out": 0,
+ *       "errors": { "server_error": 1 },
+ *       "network": { "count": 12, "sum_us": 1830211, "buckets": [ 0, 0, ... ] },
+ *       "parse": { ... },
+ *       "conversion": { ... }
+ *     }
+ *   }
+ *
+ */
+QVariantMap GiantswarmMetrics::toVariantMap() {
+    QMutexLocker locker(&m_mutex);
+    QVector<Snapshot> endpoints = m_endpoints;
+    locker.unlock();
+
+    QVariantMap result;
+
+    for (int i = 0; i < endpoints.size(); ++i) {
+        const Snapshot& metrics = endpoints.at(i);
+
+        QVariantMap errors;
+        foreach (int error, metrics.errors.keys()) {
+            errors[errorName(error)] = metrics.errors.value(error);
+        }
+
+        QVariantMap endpoint;
+        endpoint["requests"] = metrics.requests;
+        endpoint["cache_hits"] = metrics.cacheHits;
+        endpoint["cache_misses"] = metrics.cacheMisses;
+        endpoint["bytes_in"] = metrics.bytesIn;
+        endpoint["bytes_out"] = metrics.bytesOut;
+        endpoint["errors"] = errors;
+
+        for (int phase = 0; phase < PhaseCount; ++phase) {
+            const Histogram& histogram = metrics.latency[phase];
+
+            QVariantList buckets;
+            foreach (qint64 count, histogram.buckets) {
+                buckets.append(count);
+            }
+
+            QVariantMap latency;
+            latency["count"] = histogram.count;
+            latency["sum_us"] = histogram.sumUs;
+            latency["buckets"] = buckets;
+            endpoint[phaseName((Phase) phase)] = latency;
+        }
+
+        result[GiantswarmEndpoint::name((GiantswarmEndpoint::Endpoint) i)] = endpoint;
+    }
+
+    return result;
+}
+
+/**
+ * Renders all metrics in the Prometheus text exposition format.
+ */
+QString GiantswarmMetrics::toPrometheus() {
+    QMutexLocker locker(&m_mutex);
+    QVector<Snapshot> endpoints = m_endpoints;
+    locker.unlock();
+
+    QVector<qint64> bounds = bucketBoundsUs();
+
+    QString output;
+    QTextStream out(&output);
+
+    struct Counter {
+        const char *name;
+        const char *help;
+        qint64 Snapshot::*field;
+    };
+
+    static const Counter counters[] = {
+        { "giantswarm_requests_total", "Requests sent to the API.", &Snapshot::requests },
+        { "giantswarm_cache_hits_total", "Responses served from the cache.", &Snapshot::cacheHits },
+        { "giantswarm_cache_misses_total", "Cache lookups without a usable entry.", &Snapshot::cacheMisses },
+        { "giantswarm_received_bytes_total", "Response body bytes received.", &Snapshot::bytesIn },
+        { "giantswarm_sent_bytes_total", "Request body bytes sent.", &Snapshot::bytesOut }
+    };
+
+    for (unsigned int c = 0; c < sizeof(counters) / sizeof(counters[0]); ++c) {
+        out << "# HELP " << counters[c].name << " " << counters[c].help << "\n";
+        out << "# TYPE " << counters[c].name << " counter\n";
+
+        for (int i = 0; i < endpoints.size(); ++i) {
+            out << counters[c].name
+                << "{endpoint=\"" << GiantswarmEndpoint::name((GiantswarmEndpoint::Endpoint) i) << "\"} "
+                << endpoints.at(i).*(counters[c].field) << "\n";
+        }
+    }
+
+    out << "# HELP giantswarm_errors_total Failed calls by error.\n";
+    out << "# TYPE giantswarm_errors_total counter\n";
+
+    for (int i = 0; i < endpoints.size(); ++i) {
+        const QMap<int, qint64>& errors = endpoints.at(i).errors;
+
+        foreach (int error, errors.keys()) {
+            out << "giantswarm_errors_total"
+                << "{endpoint=\"" << GiantswarmEndpoint::name((GiantswarmEndpoint::Endpoint) i) << "\""
+                << ",error=\"" << errorName(error) << "\"} "
+                << errors.value(error) << "\n";
+        }
+    }
+
+    out << "# HELP giantswarm_latency_seconds Time spent per call phase.\n";
+    out << "# TYPE giantswarm_latency_seconds histogram\n";
+
+    for (int i = 0; i < endpoints.size(); ++i) {
+        QString endpoint = GiantswarmEndpoint::name((GiantswarmEndpoint::Endpoint) i);
+
+        for (int phase = 0; phase < PhaseCount; ++phase) {
+            const Histogram& histogram = endpoints.at(i).latency[phase];
+            QString labels = "endpoint=\"" + endpoint + "\",phase=\"" + phaseName((Phase) phase) + "\"";
+
+            qint64 cumulative = 0;
+            for (int b = 0; b < bounds.size(); ++b) {
+                cumulative += histogram.buckets.at(b);
+                out << "giantswarm_latency_seconds_bucket{" << labels
+                    << ",le=\"" << QString::number(bounds.at(b) / 1000000.0) << "\"} "
+                    << cumulative << "\n";
+            }
+
+            out << "giantswarm_latency_seconds_bucket{" << labels << ",le=\"+Inf\"} " << histogram.count << "\n";
+            out << "giantswarm_latency_seconds_sum{" << labels << "} " << QString::number(histogram.sumUs / 1000000.0) << "\n";
+            out << "giantswarm_latency_seconds_count{" << labels << "} " << histogram.count << "\n";
+        }
+    }
+
+    out.flush();
+    return output;
+}
+
+void GiantswarmMetrics::reset() {
+    QMutexLocker locker(&m_mutex);
+    m_endpoints.fill(emptySnapshot(), GiantswarmEndpoint::Count);
+}
+
+QString GiantswarmMetrics::phaseName(Phase phase) {
+    switch (phase) {
+        case Network:
+          return "network";
+
+        case Parse:
+          return "parse";
+
+        case Conversion:
+          return "conversion";
+    }
+
+    return QString();
+}
+
+QString GiantswarmMetrics::errorName(int error) {
+    static const char *names[] = {
+        "invalid_json_from_cache",
+        "invalid_json_from_api",
+        "not_allowed_to_request_uri",
+        "client_error",
+        "server_error",
+        "response_contains_redirection",
+        "not_found",
+        "unexpected_response_status",
+        "login_required",
+        "logout_required",
+        "response_status_mismatch",
+        "invalid_cache_entry"
+    };
+
+    if (error < 0 || error >= (int) (sizeof(names) / sizeof(names[0]))) {
+        return QString::number(error);
+    }
+
+    return names[error];
+}
+
+GiantswarmMetrics::Snapshot GiantswarmMetrics::emptySnapshot() {
+    Snapshot snapshot;
+    snapshot.requests = 0;
+    snapshot.cacheHits = 0;
+    snapshot.cacheMisses = 0;
+    snapshot.bytesIn = 0;
+    snapshot.bytesOut = 0;
+
+    for (int phase = 0; phase < PhaseCount; ++phase) {
+        snapshot.latency[phase].buckets.fill(0, bucketBoundsUs().size() + 1);
+        snapshot.latency[phase].count = 0;
+        snapshot.latency[phase].sumUs = 0;
+    }
+
+    return snapshot;
+}
@@ -0,0 +1,92 @@
+#ifndef BIDSTACK_GIANTSWARM_METRICS_HPP
+#define BIDSTACK_GIANTSWARM_METRICS_HPP
+
+#include <QElapsedTimer>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <QVariantMap>
+#include <QVector>
+
+#include "giantswarmendpoint.hpp"
+#include "giantswarmerror.hpp"
+
+namespace Bidstack {
+    namespace Giantswarm {
+
+        /**
+         * Per-endpoint counters and latency histograms of a client. All
+         * methods are safe to call from any thread.
+         */
+        class GiantswarmMetrics {
+        public:
+            enum Phase {
+                Network = 0,
+                Parse = 1,
+                Conversion = 2
+            };
+
+            static const int PhaseCount = Conversion + 1;
+
+            struct Histogram {
+                QVector<qint64> buckets;
+                qint64 count;
+                qint64 sumUs;
+            };
+
+            struct Snapshot {
+                qint64 requests;
+                qint64 cacheHits;
+                qint64 cacheMisses;
+                qint64 bytesIn;
+                qint64 bytesOut;
+                QMap<int, qint64> errors;
+                Histogram latency[PhaseCount];
+            };
+
+            /**
+             * Records the time from its construction to its destruction.
+             */
+            class Timer {
+            public:
+                Timer(GiantswarmMetrics *metrics, GiantswarmEndpoint::Endpoint endpoint, Phase phase);
+                ~Timer();
+
+            private:
+                GiantswarmMetrics *m_metrics;
+                GiantswarmEndpoint::Endpoint m_endpoint;
+                Phase m_phase;
+                QElapsedTimer m_timer;
+            };
+
+        public:
+            GiantswarmMetrics();
+
+        public:
+            static QVector<qint64> bucketBoundsUs();
+
+            void recordRequest(GiantswarmEndpoint::Endpoint endpoint, qint64 bytesOut, qint64 bytesIn);
+            void recordError(GiantswarmEndpoint::Endpoint endpoint, GiantswarmError::Error error);
+            void recordCacheHit(GiantswarmEndpoint::Endpoint endpoint);
+            void recordCacheMiss(GiantswarmEndpoint::Endpoint endpoint);
+            void recordLatency(GiantswarmEndpoint::Endpoint endpoint, Phase phase, qint64 us);
+
+            Snapshot snapshot(GiantswarmEndpoint::Endpoint endpoint);
+            QVariantMap toVariantMap();
+            QString toPrometheus();
+            void reset();
+
+        private:
+            static QString phaseName(Phase phase);
+            static QString errorName(int error);
+            static Snapshot emptySnapshot();
+
+        private:
+            QMutex m_mutex;
+            QVector<Snapshot> m_endpoints;
+        };
+
+    };
+};
+
+#endif
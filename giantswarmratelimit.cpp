@@ -0,0 +1,31 @@
+#include "giantswarmratelimit.hpp"
+
+using namespace Bidstack::Giantswarm;
+
+GiantswarmRateLimit::GiantswarmRateLimit() {
+    m_rate = 0;
+    m_burst = 1;
+    m_maxInFlight = 0;
+}
+
+GiantswarmRateLimit::GiantswarmRateLimit(double rate, int burst, int maxInFlight) {
+    m_rate = qMax(0.0, rate);
+    m_burst = qMax(1, burst);
+    m_maxInFlight = qMax(0, maxInFlight);
+}
+
+double GiantswarmRateLimit::rate() const {
+    return m_rate;
+}
+
+int GiantswarmRateLimit::burst() const {
+    return m_burst;
+}
+
+int GiantswarmRateLimit::maxInFlight() const {
+    return m_maxInFlight;
+}
+
+bool GiantswarmRateLimit::isUnlimited() const {
+    return m_rate <= 0 && m_maxInFlight <= 0;
+}
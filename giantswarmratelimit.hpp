@@ -0,0 +1,35 @@
+#ifndef BIDSTACK_GIANTSWARM_RATELIMIT_HPP
+#define BIDSTACK_GIANTSWARM_RATELIMIT_HPP
+
+#include <QtGlobal>
+
+namespace Bidstack {
+    namespace Giantswarm {
+
+        /**
+         * How many requests may start per second, how many of them may start
+         * at once after a quiet period (burst), and how many may be running
+         * at the same time. A rate or maxInFlight of zero does not limit.
+         */
+        class GiantswarmRateLimit {
+        public:
+            GiantswarmRateLimit();
+            GiantswarmRateLimit(double rate, int burst = 1, int maxInFlight = 0);
+
+        public:
+            double rate() const;
+            int burst() const;
+            int maxInFlight() const;
+
+            bool isUnlimited() const;
+
+        private:
+            double m_rate;
+            int m_burst;
+            int m_maxInFlight;
+        };
+
+    };
+};
+
+#endif
@@ -0,0 +1,74 @@
+#include <QEventLoop>
+
+#include "giantswarmreply.hpp"
+
+using namespace Bidstack::Giantswarm;
+
+GiantswarmReply::GiantswarmReply(QObject *parent) : QObject(parent) {
+    m_finished = false;
+    m_error = -1;
+}
+
+bool GiantswarmReply::isFinished() const {
+    return m_finished;
+}
+
+bool GiantswarmReply::hasError() const {
+    return m_error >= 0;
+}
+
+GiantswarmError::Error GiantswarmReply::error() const {
+    return (GiantswarmError::Error) m_error;
+}
+
+QString GiantswarmReply::errorString() const {
+    if (!hasError()) {
+        return QString();
+    }
+
+    GiantswarmError err;
+    err.error = error();
+    return err.errorString();
+}
+
+QVariant GiantswarmReply::result() const {
+    return m_result;
+}
+
+bool GiantswarmReply::toBool() const {
+    return m_result.toBool();
+}
+
+QVariantList GiantswarmReply::toList() const {
+    return m_result.toList();
+}
+
+QVariantMap GiantswarmReply::toMap() const {
+    return m_result.toMap();
+}
+
+/**
+ * Blocks until the reply has finished while still processing events of
+ * the calling thread, which is where the result gets delivered.
+ */
+bool GiantswarmReply::waitForFinished() {
+    if (!m_finished) {
+        QEventLoop loop;
+        connect(this, SIGNAL(finished()), &loop, SLOT(quit()));
+        loop.exec();
+    }
+
+    return !hasError();
+}
+
+void GiantswarmReply::complete(QVariant result, int error) {
+    if (m_finished) {
+        return;
+    }
+
+    m_result = result;
+    m_error = error;
+    m_finished = true;
+
+    emit finished();
+}
@@ -0,0 +1,55 @@
+#ifndef BIDSTACK_GIANTSWARM_REPLY_HPP
+#define BIDSTACK_GIANTSWARM_REPLY_HPP
+
+#include <QObject>
+#include <QString>
+#include <QVariant>
+#include <QVariantList>
+#include <QVariantMap>
+
+#include "giantswarmerror.hpp"
+
+namespace Bidstack {
+    namespace Giantswarm {
+
+        /**
+         * Result of an asynchronous GiantswarmClient call. The reply lives
+         * in the thread that made the call and is owned by the caller, who
+         * deletes it once it is no longer needed. Its result is delivered
+         * through that thread's event loop.
+         */
+        class GiantswarmReply : public QObject {
+            Q_OBJECT
+
+        public:
+            GiantswarmReply(QObject *parent = 0);
+
+        public:
+            Q_INVOKABLE bool isFinished() const;
+            Q_INVOKABLE bool hasError() const;
+            GiantswarmError::Error error() const;
+            Q_INVOKABLE QString errorString() const;
+
+            Q_INVOKABLE QVariant result() const;
+            Q_INVOKABLE bool toBool() const;
+            Q_INVOKABLE QVariantList toList() const;
+            Q_INVOKABLE QVariantMap toMap() const;
+
+            bool waitForFinished();
+
+        signals:
+            void finished();
+
+        public slots:
+            void complete(QVariant result, int error);
+
+        private:
+            bool m_finished;
+            int m_error;
+            QVariant m_result;
+        };
+
+    };
+};
+
+#endif
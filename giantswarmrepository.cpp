@@ -1,11 +1,158 @@
+#include <QAtomicInt>
+#include <QDebug>
+#include <QMutexLocker>
+#include <QSqlError>
+#include <QStringList>
+
 #include "giantswarmrepository.hpp"
 
 using namespace Bidstack::Giantswarm;
 
+static QAtomicInt connectionCounter(0);
+
 GiantswarmRepository::GiantswarmRepository(QSqlDatabase& database, QObject *parent) : QObject(parent) {
-    m_database = database;
+    m_ownerThread = QThread::currentThread();
+    m_connection.database = database;
+    configure(m_connection.database);
+}
+
+/**
+ * Closes the connections of all threads which are still running. Their
+ * handles stay behind, as QThreadStorage no longer cleans up once it is
+ * gone, but they do not touch the repository anymore.
+ */
+GiantswarmRepository::~GiantswarmRepository() {
+    QMutexLocker locker(&m_clonesMutex);
+    QList<Connection*> clones = m_clones;
+    m_clones.clear();
+    locker.unlock();
+
+    qDeleteAll(clones);
+}
+
+GiantswarmRepository::Handle::~Handle() {
+    repository->release(connection);
+}
+
+GiantswarmRepository::Connection::~Connection() {
+    statements.clear();
+
+    // The connection handed to the constructor belongs to the caller.
+    if (!name.isEmpty()) {
+        database.close();
+        database = QSqlDatabase();
+        QSqlDatabase::removeDatabase(name);
+    }
+}
+
+/**
+ * Applies the profile to the connection of the owning thread right away.
+ * Connections of other threads pick it up when they are opened.
+ */
+void GiantswarmRepository::setStorageProfile(const GiantswarmStorageProfile& profile) {
+    {
+        QMutexLocker locker(&m_profileMutex);
+        m_profile = profile;
+    }
+
+    if (QThread::currentThread() == m_ownerThread) {
+        configure(m_connection.database);
+    }
+}
+
+GiantswarmStorageProfile GiantswarmRepository::storageProfile() const {
+    QMutexLocker locker(&m_profileMutex);
+    return m_profile;
 }
 
 QSqlDatabase& GiantswarmRepository::database() {
-    return m_database;
+    return connection()->database;
+}
+
+/**
+ * Returns a query for the given SQL which is prepared on first use and
+ * kept for the lifetime of the repository. Callers bind their values,
+ * execute it and call finish() once they are done reading results.
+ * Every thread has its own set of prepared statements.
+ */
+QSqlQuery& GiantswarmRepository::statement(const QString& sql) {
+    Connection *conn = connection();
+    QHash<QString, QSqlQuery>::iterator it = conn->statements.find(sql);
+
+    if (it == conn->statements.end()) {
+        it = conn->statements.insert(sql, QSqlQuery(conn->database));
+    }
+
+    // Statements which failed to prepare, e.g. because their table did not
+    // exist yet, are prepared again on their next use.
+    if (!conn->prepared.contains(sql)) {
+        if (it.value().prepare(sql)) {
+            conn->prepared.insert(sql);
+        } else {
+            qWarning() << "Failed to prepare statement:" << it.value().lastError().text();
+        }
+    }
+
+    return it.value();
+}
+
+GiantswarmRepository::Connection* GiantswarmRepository::connection() {
+    if (QThread::currentThread() == m_ownerThread) {
+        return &m_connection;
+    }
+
+    if (!m_threadConnections.hasLocalData()) {
+        Connection *conn = new Connection();
+        conn->name = QString("%1_%2")
+            .arg(m_connection.database.connectionName())
+            .arg(connectionCounter.fetchAndAddOrdered(1));
+        conn->database = QSqlDatabase::cloneDatabase(m_connection.database, conn->name);
+
+        if (conn->database.open()) {
+            configure(conn->database);
+        } else {
+            qWarning() << "Failed to open database connection:" << conn->database.lastError().text();
+        }
+
+        QMutexLocker locker(&m_clonesMutex);
+        m_clones.append(conn);
+        locker.unlock();
+
+        Handle *handle = new Handle();
+        handle->repository = this;
+        handle->connection = conn;
+        m_threadConnections.setLocalData(handle);
+    }
+
+    return m_threadConnections.localData()->connection;
+}
+
+/**
+ * Closes the connection of a finishing thread, unless the repository got
+ * to it first.
+ */
+void GiantswarmRepository::release(Connection *connection) {
+    QMutexLocker locker(&m_clonesMutex);
+    bool owned = m_clones.removeOne(connection);
+    locker.unlock();
+
+    if (owned) {
+        delete connection;
+    }
+}
+
+void GiantswarmRepository::configure(QSqlDatabase& database) {
+    if (!database.isOpen()) {
+        return;
+    }
+
+    foreach (QString pragma, storageProfile().pragmas()) {
+        QSqlQuery stmt(database);
+        stmt.exec(pragma);
+
+        QSqlError err = stmt.lastError();
+        if (err.isValid()) {
+            qWarning() << "Failed to apply" << pragma << ":" << err.text();
+        }
+    }
 }
@@ -1,24 +1,83 @@
 #ifndef BIDSTACK_GIANTSWARM_REPOSITORY_HPP
 #define BIDSTACK_GIANTSWARM_REPOSITORY_HPP
 
+#include <QHash>
+#include <QList>
+#include <QMutex>
 #include <QObject>
 #include <QSqlDatabase>
+#include <QSet>
+#include <QSqlQuery>
+#include <QString>
+#include <QThread>
+#include <QThreadStorage>
+
+#include "giantswarmstorageprofile.hpp"
 
 namespace Bidstack {
     namespace Giantswarm {
 
+        /**
+         * Base class of all repositories. The database passed in is used
+         * from the thread that created the repository; every other thread
+         * gets its own clone of it, opened on first use. A clone is closed
+         * when its thread finishes, or when the repository is destroyed,
+         * whichever comes first. Clones of in-memory databases are separate,
+         * empty databases, so only file databases can be shared this way.
+         */
         class GiantswarmRepository : public QObject {
             Q_OBJECT
 
         public:
             GiantswarmRepository(QSqlDatabase& database, QObject *parent = 0);
+            virtual ~GiantswarmRepository();
+
+        public:
+            void setStorageProfile(const GiantswarmStorageProfile& profile);
+            GiantswarmStorageProfile storageProfile() const;
 
         protected:
             QSqlDatabase& database();
+            QSqlQuery& statement(const QString& sql);
             virtual void init() =0;
 
         private:
-            QSqlDatabase m_database;
+            struct Connection {
+                ~Connection();
+
+                QString name;
+                QSqlDatabase database;
+                QHash<QString, QSqlQuery> statements;
+                QSet<QString> prepared;
+            };
+
+            /**
+             * Closes the connection of its thread when the thread finishes
+             * first. The connection itself is owned by the repository.
+             */
+            struct Handle {
+                ~Handle();
+
+                GiantswarmRepository *repository;
+                Connection *connection;
+            };
+
+            Connection* connection();
+            void release(Connection *connection);
+            void configure(QSqlDatabase& database);
+
+        private:
+            QThread *m_ownerThread;
+            Connection m_connection;
+
+            // Declared before the thread storage, so that a thread which
+            // finishes while the repository is destroyed still finds them.
+            QList<Connection*> m_clones;
+            QMutex m_clonesMutex;
+            QThreadStorage<Handle*> m_threadConnections;
+
+            GiantswarmStorageProfile m_profile;
+            mutable QMutex m_profileMutex;
         };
 
     };
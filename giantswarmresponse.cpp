@@ -0,0 +1,126 @@
+#include <cctype>
+
+#include "giantswarmresponse.hpp"
+
+#include "deps/qjson4/QJsonDocument.h"
+#include "deps/qjson4/QJsonParseError.h"
+
+using namespace Bidstack::Giantswarm;
+
+GiantswarmResponse::GiantswarmResponse() {
+    m_endpoint = -1;
+    m_status = 0;
+    m_statusCode = 0;
+    m_valid = false;
+}
+
+GiantswarmResponse::GiantswarmResponse(int status, QMap<QString, QString> headers, QByteArray body, ParseMode mode) {
+    m_endpoint = -1;
+    m_status = status;
+    m_headers = headers;
+    m_body = body;
+    m_statusCode = 0;
+    m_valid = false;
+
+    if (mode == ParseDocument) {
+        parse();
+    }
+}
+
+/**
+ * The GiantswarmEndpoint the response belongs to, or -1 if unknown.
+ */
+void GiantswarmResponse::setEndpoint(int endpoint) {
+    m_endpoint = endpoint;
+}
+
+int GiantswarmResponse::endpoint() const {
+    return m_endpoint;
+}
+
+int GiantswarmResponse::status() const {
+    return m_status;
+}
+
+QMap<QString, QString> GiantswarmResponse::headers() const {
+    return m_headers;
+}
+
+QByteArray GiantswarmResponse::body() const {
+    return m_body;
+}
+
+bool GiantswarmResponse::isValid() const {
+    return m_valid;
+}
+
+int GiantswarmResponse::statusCode() const {
+    return m_statusCode;
+}
+
+QJsonObject GiantswarmResponse::object() const {
+    return m_object;
+}
+
+QJsonValue GiantswarmResponse::data() const {
+    return m_object["data"];
+}
+
+void GiantswarmResponse::parse() {
+    // Only API envelopes are parsed; plain bodies like the one returned
+    // by /ping are left alone.
+    int i = 0;
+    while (i < m_body.size() && isspace((unsigned char) m_body.at(i))) {
+        ++i;
+    }
+
+    if (i == m_body.size() || m_body.at(i) != '{') {
+        return;
+    }
+
+    QJsonParseError err;
+    QJsonDocument doc = QJsonDocument::fromJson(m_body, &err);
+
+    if (!doc.isNull() && doc.isObject()) {
+        m_object = doc.object();
+        m_statusCode = (int) m_object["status_code"].toDouble();
+        m_valid = true;
+    }
+}
+
+/**
+ * Walks the top-level object of a Streamed response once, handing data to
+ * the given reader and keeping status_code, so statusCode() and isValid()
+ * can be checked afterwards. The body counts as valid if it is well-formed
+ * and data could be decoded.
+ */
+bool GiantswarmResponse::read(DataReader *data) {
+    GiantswarmJsonReader reader(m_body);
+
+    m_statusCode = 0;
+    m_valid = false;
+
+    if (reader.next() != GiantswarmJsonReader::BeginObject) {
+        return false;
+    }
+
+    while (reader.next() == GiantswarmJsonReader::Name) {
+        QString name = reader.string();
+        reader.next();
+
+        if (name == QLatin1String("status_code")) {
+            m_statusCode = (int) reader.numberValue();
+        } else if (name == QLatin1String("data") && data) {
+            if (!data->read(reader)) {
+                return false;
+            }
+        } else if (!reader.skip()) {
+            return false;
+        }
+    }
+
+    m_valid = reader.token() == GiantswarmJsonReader::EndObject
+        && reader.next() == GiantswarmJsonReader::EndOfDocument;
+
+    return m_valid;
+}
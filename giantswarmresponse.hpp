@@ -0,0 +1,84 @@
+#ifndef BIDSTACK_GIANTSWARM_RESPONSE_HPP
+#define BIDSTACK_GIANTSWARM_RESPONSE_HPP
+
+#include <QByteArray>
+#include <QMap>
+#include <QString>
+
+#include "giantswarmjsonreader.hpp"
+
+#include "deps/qjson4/QJsonArray.h"
+#include "deps/qjson4/QJsonObject.h"
+#include "deps/qjson4/QJsonValue.h"
+
+namespace Bidstack {
+    namespace Giantswarm {
+
+        /**
+         * An API response together with its JSON document, which is parsed
+         * exactly once when the response is constructed and then shared by
+         * status code validation and data extraction.
+         *
+         * Responses are plain values; the body and the parsed document are
+         * implicitly shared, so copies are cheap and nothing has to be
+         * released by the caller.
+         *
+         * With Streamed nothing is parsed up front. The caller passes a
+         * DataReader to read(), which walks the body once with a
+         * GiantswarmJsonReader, decoding data and picking up status_code
+         * on the way; object() and data() stay empty.
+         */
+        class GiantswarmResponse {
+        public:
+            enum ParseMode {
+                ParseDocument = 0,
+                Streamed = 1
+            };
+
+            /**
+             * Decodes the data member of a Streamed response, starting
+             * with the reader on its first token.
+             */
+            class DataReader {
+            public:
+                virtual ~DataReader() {}
+                virtual bool read(GiantswarmJsonReader& reader) = 0;
+            };
+
+        public:
+            GiantswarmResponse();
+            GiantswarmResponse(int status, QMap<QString, QString> headers, QByteArray body, ParseMode mode = ParseDocument);
+
+        public:
+            void setEndpoint(int endpoint);
+            int endpoint() const;
+
+            int status() const;
+            QMap<QString, QString> headers() const;
+            QByteArray body() const;
+
+            bool isValid() const;
+            int statusCode() const;
+            QJsonObject object() const;
+            QJsonValue data() const;
+
+            bool read(DataReader *data);
+
+        private:
+            void parse();
+
+        private:
+            int m_endpoint;
+            int m_status;
+            QMap<QString, QString> m_headers;
+            QByteArray m_body;
+
+            QJsonObject m_object;
+            int m_statusCode;
+            bool m_valid;
+        };
+
+    };
+};
+
+#endif
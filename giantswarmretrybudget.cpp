@@ -0,0 +1,34 @@
+#include <QMutexLocker>
+
+#include "giantswarmretrybudget.hpp"
+
+using namespace Bidstack::Giantswarm;
+
+GiantswarmRetryBudget::GiantswarmRetryBudget(double ratio, int maxTokens) {
+    m_ratio = qMax(0.0, ratio);
+    m_maxTokens = qMax(0, maxTokens);
+    m_tokens = m_maxTokens;
+}
+
+void GiantswarmRetryBudget::configure(double ratio, int maxTokens) {
+    QMutexLocker locker(&m_mutex);
+    m_ratio = qMax(0.0, ratio);
+    m_maxTokens = qMax(0, maxTokens);
+    m_tokens = qMin(m_tokens, m_maxTokens);
+}
+
+void GiantswarmRetryBudget::deposit() {
+    QMutexLocker locker(&m_mutex);
+    m_tokens = qMin(m_maxTokens, m_tokens + m_ratio);
+}
+
+bool GiantswarmRetryBudget::withdraw() {
+    QMutexLocker locker(&m_mutex);
+
+    if (m_tokens < 1.0) {
+        return false;
+    }
+
+    m_tokens -= 1.0;
+    return true;
+}
@@ -0,0 +1,40 @@
+#ifndef BIDSTACK_GIANTSWARM_RETRYBUDGET_HPP
+#define BIDSTACK_GIANTSWARM_RETRYBUDGET_HPP
+
+#include <QMutex>
+
+namespace Bidstack {
+    namespace Giantswarm {
+
+        const double DEFAULT_RETRY_BUDGET_RATIO = 0.1;
+        const int DEFAULT_RETRY_BUDGET_TOKENS = 10;
+
+        /**
+         * Limits retries across a whole client to a share of the requests
+         * it sends. Every first attempt deposits ratio tokens, up to
+         * maxTokens, and every retry withdraws one; without a whole token
+         * left the request fails instead of being retried. During an outage
+         * retries therefore add at most ratio to the load after the initial
+         * maxTokens have been used up.
+         */
+        class GiantswarmRetryBudget {
+        public:
+            GiantswarmRetryBudget(double ratio = DEFAULT_RETRY_BUDGET_RATIO, int maxTokens = DEFAULT_RETRY_BUDGET_TOKENS);
+
+        public:
+            void configure(double ratio, int maxTokens);
+
+            void deposit();
+            bool withdraw();
+
+        private:
+            QMutex m_mutex;
+            double m_ratio;
+            double m_maxTokens;
+            double m_tokens;
+        };
+
+    };
+};
+
+#endif
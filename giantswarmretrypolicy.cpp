@@ -0,0 +1,106 @@
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QLocale>
+#include <QThread>
+#include <QThreadStorage>
+
+#include "giantswarmretrypolicy.hpp"
+
+using namespace Bidstack::Giantswarm;
+
+namespace {
+
+    QThreadStorage<bool*> seeded;
+
+    /**
+     * qrand() starts from the same seed in every thread, so each thread
+     * seeds it once before its first draw.
+     */
+    void seedThread() {
+        if (seeded.hasLocalData()) {
+            return;
+        }
+
+        uint seed = (uint) QDateTime::currentMSecsSinceEpoch();
+        seed ^= (uint) (quintptr) QThread::currentThreadId();
+        seed ^= (uint) QCoreApplication::applicationPid() << 16;
+
+        qsrand(seed);
+        seeded.setLocalData(new bool(true));
+    }
+
+};
+
+GiantswarmRetryPolicy::GiantswarmRetryPolicy() {
+    m_maxAttempts = 1;
+    m_baseDelay = 0;
+    m_maxDelay = 0;
+}
+
+GiantswarmRetryPolicy::GiantswarmRetryPolicy(int maxAttempts, int baseDelay, int maxDelay) {
+    m_maxAttempts = qMax(1, maxAttempts);
+    m_baseDelay = qMax(0, baseDelay);
+    m_maxDelay = qMax(m_baseDelay, maxDelay);
+}
+
+int GiantswarmRetryPolicy::maxAttempts() const {
+    return m_maxAttempts;
+}
+
+int GiantswarmRetryPolicy::baseDelay() const {
+    return m_baseDelay;
+}
+
+int GiantswarmRetryPolicy::maxDelay() const {
+    return m_maxDelay;
+}
+
+/**
+ * Whether another attempt may follow the given one, counting from 1.
+ */
+bool GiantswarmRetryPolicy::allowsRetry(int attempt) const {
+    return attempt < m_maxAttempts;
+}
+
+int GiantswarmRetryPolicy::delay(int retry) const {
+    qint64 ceiling = m_baseDelay;
+    for (int i = 1; i < retry && ceiling < m_maxDelay; ++i) {
+        ceiling *= 2;
+    }
+
+    ceiling = qMin(ceiling, (qint64) m_maxDelay);
+    if (ceiling <= 0) {
+        return 0;
+    }
+
+    seedThread();
+
+    return qrand() % (int) (ceiling + 1);
+}
+
+/**
+ * The wait a Retry-After header asks for, in milliseconds and at most a
+ * day, or -1 if it is neither a number of seconds nor an HTTP date.
+ */
+int GiantswarmRetryPolicy::retryAfter(const QString& value) {
+    QString trimmed = value.trimmed();
+    if (trimmed.isEmpty()) {
+        return -1;
+    }
+
+    bool ok;
+    int seconds = trimmed.toInt(&ok);
+    if (ok) {
+        return seconds < 0 ? -1 : qMin(seconds, 86400) * 1000;
+    }
+
+    QDateTime date = QLocale::c().toDateTime(trimmed, "ddd, dd MMM yyyy hh:mm:ss 'GMT'");
+    if (!date.isValid()) {
+        return -1;
+    }
+
+    date.setTimeSpec(Qt::UTC);
+    qint64 msecs = date.toMSecsSinceEpoch() - QDateTime::currentMSecsSinceEpoch();
+
+    return (int) qBound((qint64) 0, msecs, (qint64) 86400000);
+}
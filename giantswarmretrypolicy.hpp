@@ -0,0 +1,47 @@
+#ifndef BIDSTACK_GIANTSWARM_RETRYPOLICY_HPP
+#define BIDSTACK_GIANTSWARM_RETRYPOLICY_HPP
+
+#include <QString>
+#include <QtGlobal>
+
+namespace Bidstack {
+    namespace Giantswarm {
+
+        const int MAX_RETRY_AFTER = 30;
+
+        /**
+         * How often a request failing with a server error or 429 Too Many
+         * Requests is attempted, in total, and how long to wait in between,
+         * in milliseconds.
+         *
+         * The wait before retry n is drawn uniformly from zero up to
+         * baseDelay * 2^(n - 1), capped at maxDelay ("full jitter"), so that
+         * clients failing at the same moment do not retry in lockstep. The
+         * random numbers are seeded per thread, from the time and the thread,
+         * so threads and processes draw different waits.
+         */
+        class GiantswarmRetryPolicy {
+        public:
+            GiantswarmRetryPolicy();
+            GiantswarmRetryPolicy(int maxAttempts, int baseDelay = 100, int maxDelay = 2000);
+
+        public:
+            int maxAttempts() const;
+            int baseDelay() const;
+            int maxDelay() const;
+
+            bool allowsRetry(int attempt) const;
+            int delay(int retry) const;
+
+            static int retryAfter(const QString& value);
+
+        private:
+            int m_maxAttempts;
+            int m_baseDelay;
+            int m_maxDelay;
+        };
+
+    };
+};
+
+#endif
@@ -0,0 +1,71 @@
+#include "giantswarmstorageprofile.hpp"
+
+using namespace Bidstack::Giantswarm;
+
+GiantswarmStorageProfile::GiantswarmStorageProfile() {
+    m_journalMode = "WAL";
+    m_synchronous = "NORMAL";
+    m_cacheSize = DEFAULT_STORAGE_CACHE_SIZE;
+    m_mmapSize = DEFAULT_STORAGE_MMAP_SIZE;
+    m_busyTimeout = DEFAULT_STORAGE_BUSY_TIMEOUT;
+}
+
+GiantswarmStorageProfile::GiantswarmStorageProfile(QString journalMode, QString synchronous, int cacheSize, qint64 mmapSize, int busyTimeout) {
+    m_journalMode = journalMode;
+    m_synchronous = synchronous;
+    m_cacheSize = cacheSize;
+    m_mmapSize = mmapSize;
+    m_busyTimeout = busyTimeout;
+}
+
+QString GiantswarmStorageProfile::journalMode() const {
+    return m_journalMode;
+}
+
+QString GiantswarmStorageProfile::synchronous() const {
+    return m_synchronous;
+}
+
+int GiantswarmStorageProfile::cacheSize() const {
+    return m_cacheSize;
+}
+
+qint64 GiantswarmStorageProfile::mmapSize() const {
+    return m_mmapSize;
+}
+
+int GiantswarmStorageProfile::busyTimeout() const {
+    return m_busyTimeout;
+}
+
+/**
+ * Returns the PRAGMA statements to run on a freshly opened connection.
+ * busy_timeout comes first so that switching the journal mode already
+ * waits for other connections instead of failing right away.
+ */
+QStringList GiantswarmStorageProfile::pragmas() const {
+    QStringList pragmas;
+
+    if (m_busyTimeout >= 0) {
+        pragmas << QString("PRAGMA busy_timeout = %1").arg(m_busyTimeout);
+    }
+
+    if (!m_journalMode.isEmpty()) {
+        pragmas << QString("PRAGMA journal_mode = %1").arg(m_journalMode);
+    }
+
+    if (!m_synchronous.isEmpty()) {
+        pragmas << QString("PRAGMA synchronous = %1").arg(m_synchronous);
+    }
+
+    if (m_cacheSize >= 0) {
+        // Negative values are interpreted by SQLite as KiB instead of pages.
+        pragmas << QString("PRAGMA cache_size = -%1").arg(m_cacheSize);
+    }
+
+    if (m_mmapSize >= 0) {
+        pragmas << QString("PRAGMA mmap_size = %1").arg(m_mmapSize);
+    }
+
+    return pragmas;
+}
@@ -0,0 +1,54 @@
+#ifndef BIDSTACK_GIANTSWARM_STORAGEPROFILE_HPP
+#define BIDSTACK_GIANTSWARM_STORAGEPROFILE_HPP
+
+#include <QString>
+#include <QStringList>
+#include <QtGlobal>
+
+namespace Bidstack {
+    namespace Giantswarm {
+
+        const int DEFAULT_STORAGE_CACHE_SIZE = 8192;
+        const qint64 DEFAULT_STORAGE_MMAP_SIZE = 64 * 1024 * 1024;
+        const int DEFAULT_STORAGE_BUSY_TIMEOUT = 5000;
+
+        /**
+         * SQLite settings applied to every connection of a repository.
+         *
+         *  - journalMode: PRAGMA journal_mode, "WAL" lets readers run
+         *    concurrently with a writer. Ignored for in-memory databases.
+         *  - synchronous: PRAGMA synchronous, "NORMAL" is durable in WAL
+         *    mode except for the last commits before a power loss.
+         *  - cacheSize: page cache per connection, in KiB.
+         *  - mmapSize: bytes of the database file to memory-map, 0 disables.
+         *  - busyTimeout: milliseconds to wait for a lock held by another
+         *    connection before failing with SQLITE_BUSY.
+         *
+         * Empty modes and negative sizes leave the SQLite default in place.
+         */
+        class GiantswarmStorageProfile {
+        public:
+            GiantswarmStorageProfile();
+            GiantswarmStorageProfile(QString journalMode, QString synchronous, int cacheSize, qint64 mmapSize, int busyTimeout);
+
+        public:
+            QString journalMode() const;
+            QString synchronous() const;
+            int cacheSize() const;
+            qint64 mmapSize() const;
+            int busyTimeout() const;
+
+            QStringList pragmas() const;
+
+        private:
+            QString m_journalMode;
+            QString m_synchronous;
+            int m_cacheSize;
+            qint64 m_mmapSize;
+            int m_busyTimeout;
+        };
+
+    };
+};
+
+#endif
@@ -0,0 +1,74 @@
+#include <QDebug>
+#include <QMetaObject>
+#include <QMetaType>
+
+#include "giantswarmtask.hpp"
+#include "giantswarmclient.hpp"
+#include "giantswarmerror.hpp"
+
+using namespace Bidstack::Giantswarm;
+
+GiantswarmTask::GiantswarmTask(GiantswarmClient *client, const char *method, const char *returnType, QVariantList args) : QObject(0) {
+    m_client = client;
+    m_method = method;
+    m_returnType = returnType;
+    m_args = args;
+
+    // The pool deletes the task as soon as run() returns, so it is freed
+    // whether or not any thread runs an event loop. The task never receives
+    // events, and detaching it from the calling thread makes deleting it
+    // from the pool thread safe; completed() is still queued to the reply.
+    moveToThread(0);
+    setAutoDelete(true);
+}
+
+void GiantswarmTask::run() {
+    QVariant result;
+    int error = invoke(m_client, m_method.constData(), m_returnType.constData(), m_args, &result);
+
+    emit completed(result, error);
+}
+
+/**
+ * Calls the method in the calling thread and returns the error it ended
+ * with, InvocationFailed if there is no such method, or -1.
+ */
+int GiantswarmTask::invoke(GiantswarmClient *client, const char *method, const char *returnType, QVariantList args, QVariant *result) {
+    QByteArray type = returnType;
+
+    *result = QVariant();
+    if (!type.isEmpty()) {
+        *result = QVariant(QMetaType::type(type.constData()), (const void *) 0);
+    }
+
+    int error = -1;
+
+    QGenericArgument arguments[6];
+    for (int i = 0; i < args.size() && i < 6; ++i) {
+        arguments[i] = QGenericArgument(args.at(i).typeName(), args.at(i).constData());
+    }
+
+    client->resetLastError();
+
+    try {
+        bool invoked = QMetaObject::invokeMethod(
+            client,
+            method,
+            Qt::DirectConnection,
+            type.isEmpty() ? QGenericReturnArgument() : QGenericReturnArgument(type.constData(), result->data()),
+            arguments[0], arguments[1], arguments[2], arguments[3], arguments[4], arguments[5]
+        );
+
+        if (!invoked) {
+            qWarning() << "Could not invoke" << method << "!";
+            error = GiantswarmError::InvocationFailed;
+        } else {
+            error = client->lastError();
+        }
+    } catch (GiantswarmError& e) {
+        qWarning() << "Error:" << e.errorString();
+        error = e.error;
+    }
+
+    return error;
+}
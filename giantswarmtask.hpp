@@ -0,0 +1,44 @@
+#ifndef BIDSTACK_GIANTSWARM_TASK_HPP
+#define BIDSTACK_GIANTSWARM_TASK_HPP
+
+#include <QByteArray>
+#include <QObject>
+#include <QRunnable>
+#include <QVariant>
+#include <QVariantList>
+
+namespace Bidstack {
+    namespace Giantswarm {
+
+        class GiantswarmClient;
+
+        /**
+         * Runs one Q_INVOKABLE method of GiantswarmClient on a pool thread
+         * and reports its return value through completed(). The pool owns
+         * the task once started.
+         */
+        class GiantswarmTask : public QObject, public QRunnable {
+            Q_OBJECT
+
+        public:
+            GiantswarmTask(GiantswarmClient *client, const char *method, const char *returnType, QVariantList args);
+
+        public:
+            void run();
+
+            static int invoke(GiantswarmClient *client, const char *method, const char *returnType, QVariantList args, QVariant *result);
+
+        signals:
+            void completed(QVariant result, int error);
+
+        private:
+            GiantswarmClient *m_client;
+            QByteArray m_method;
+            QByteArray m_returnType;
+            QVariantList m_args;
+        };
+
+    };
+};
+
+#endif
@@ -0,0 +1,251 @@
+#include <QVariantList>
+
+#include "giantswarmtypes.hpp"
+
+using namespace Bidstack::Giantswarm;
+
+/**
+ * Instance
+ */
+
+bool Instance::read(GiantswarmJsonReader& reader, Instance *instance) {
+    if (reader.token() != GiantswarmJsonReader::BeginObject) {
+        return reader.skip();
+    }
+
+    while (reader.next() == GiantswarmJsonReader::Name) {
+        QString key = reader.string();
+        reader.next();
+
+        if (key == "id") {
+            instance->id = reader.stringValue();
+        } else if (key == "status") {
+            instance->status = reader.stringValue();
+        } else if (key == "image") {
+            instance->image = reader.stringValue();
+        } else if (key == "create_date") {
+            instance->createdAt = reader.stringValue();
+        } else {
+            reader.skip();
+        }
+    }
+
+    return reader.token() == GiantswarmJsonReader::EndObject;
+}
+
+QVariantMap Instance::toVariantMap() const {
+    QVariantMap instance;
+    instance["id"] = id;
+    instance["status"] = status;
+    instance["image"] = image;
+    instance["created_at"] = createdAt;
+    return instance;
+}
+
+/**
+ * Component
+ */
+
+Component::Component() {
+    maximum = 0;
+    minimum = 0;
+}
+
+bool Component::read(GiantswarmJsonReader& reader, Component *component) {
+    if (reader.token() != GiantswarmJsonReader::BeginObject) {
+        return reader.skip();
+    }
+
+    while (reader.next() == GiantswarmJsonReader::Name) {
+        QString key = reader.string();
+        reader.next();
+
+        if (key == "name") {
+            component->name = reader.stringValue();
+        } else if (key == "status") {
+            component->status = reader.stringValue();
+        } else if (key == "max") {
+            component->maximum = (int) reader.numberValue();
+        } else if (key == "min") {
+            component->minimum = (int) reader.numberValue();
+        } else if (key == "instances" && reader.token() == GiantswarmJsonReader::BeginArray) {
+            while (reader.next() != GiantswarmJsonReader::EndArray) {
+                Instance instance;
+                if (!Instance::read(reader, &instance)) {
+                    return false;
+                }
+                component->instances.append(instance);
+            }
+        } else {
+            reader.skip();
+        }
+    }
+
+    return reader.token() == GiantswarmJsonReader::EndObject;
+}
+
+QVariantMap Component::toVariantMap() const {
+    QVariantList items;
+    foreach (const Instance& instance, instances) {
+        items.append(instance.toVariantMap());
+    }
+
+    QVariantMap component;
+    component["name"] = name;
+    component["status"] = status;
+    component["maximum"] = maximum;
+    component["minimum"] = minimum;
+    component["instances"] = items;
+    return component;
+}
+
+/**
+ * Service
+ */
+
+Service::Service() {
+    maximum = 0;
+    minimum = 0;
+}
+
+bool Service::read(GiantswarmJsonReader& reader, Service *service) {
+    if (reader.token() != GiantswarmJsonReader::BeginObject) {
+        return reader.skip();
+    }
+
+    while (reader.next() == GiantswarmJsonReader::Name) {
+        QString key = reader.string();
+        reader.next();
+
+        if (key == "name") {
+            service->name = reader.stringValue();
+        } else if (key == "status") {
+            service->status = reader.stringValue();
+        } else if (key == "max") {
+            service->maximum = (int) reader.numberValue();
+        } else if (key == "min") {
+            service->minimum = (int) reader.numberValue();
+        } else if (key == "components" && reader.token() == GiantswarmJsonReader::BeginArray) {
+            while (reader.next() != GiantswarmJsonReader::EndArray) {
+                Component component;
+                if (!Component::read(reader, &component)) {
+                    return false;
+                }
+                service->components.append(component);
+            }
+        } else {
+            reader.skip();
+        }
+    }
+
+    return reader.token() == GiantswarmJsonReader::EndObject;
+}
+
+QVariantMap Service::toVariantMap() const {
+    QVariantList items;
+    foreach (const Component& component, components) {
+        items.append(component.toVariantMap());
+    }
+
+    QVariantMap service;
+    service["name"] = name;
+    service["status"] = status;
+    service["maximum"] = maximum;
+    service["minimum"] = minimum;
+    service["components"] = items;
+    return service;
+}
+
+/**
+ * ApplicationStatus
+ */
+
+bool ApplicationStatus::read(GiantswarmJsonReader& reader, ApplicationStatus *application) {
+    if (reader.token() != GiantswarmJsonReader::BeginObject) {
+        return reader.skip();
+    }
+
+    while (reader.next() == GiantswarmJsonReader::Name) {
+        QString key = reader.string();
+        reader.next();
+
+        if (key == "name") {
+            application->name = reader.stringValue();
+        } else if (key == "status") {
+            application->status = reader.stringValue();
+        } else if (key == "services" && reader.token() == GiantswarmJsonReader::BeginArray) {
+            while (reader.next() != GiantswarmJsonReader::EndArray) {
+                Service service;
+                if (!Service::read(reader, &service)) {
+                    return false;
+                }
+                application->services.append(service);
+            }
+        } else {
+            reader.skip();
+        }
+    }
+
+    return reader.token() == GiantswarmJsonReader::EndObject;
+}
+
+QVariantMap ApplicationStatus::toVariantMap() const {
+    QVariantList items;
+    foreach (const Service& service, services) {
+        items.append(service.toVariantMap());
+    }
+
+    QVariantMap application;
+    application["name"] = name;
+    application["status"] = status;
+    application["services"] = items;
+    return application;
+}
+
+/**
+ * InstanceStatistics
+ */
+
+InstanceStatistics::InstanceStatistics() {
+    memoryUsageMb = 0;
+    memoryCapacityMb = 0;
+    memoryUsagePercent = 0;
+    cpuUsagePercent = 0;
+}
+
+bool InstanceStatistics::read(GiantswarmJsonReader& reader, InstanceStatistics *statistics) {
+    if (reader.token() != GiantswarmJsonReader::BeginObject) {
+        return reader.skip();
+    }
+
+    while (reader.next() == GiantswarmJsonReader::Name) {
+        QString key = reader.string();
+        reader.next();
+
+        if (key == "ComponentName") {
+            statistics->component = reader.stringValue();
+        } else if (key == "MemoryUsageMb") {
+            statistics->memoryUsageMb = reader.numberValue();
+        } else if (key == "MemoryCapacityMb") {
+            statistics->memoryCapacityMb = reader.numberValue();
+        } else if (key == "MemoryUsagePercent") {
+            statistics->memoryUsagePercent = reader.numberValue();
+        } else if (key == "CpuUsagePercent") {
+            statistics->cpuUsagePercent = reader.numberValue();
+        } else {
+            reader.skip();
+        }
+    }
+
+    return reader.token() == GiantswarmJsonReader::EndObject;
+}
+
+QVariantMap InstanceStatistics::toVariantMap() const {
+    QVariantMap statistics;
+    statistics["component"] = component;
+    statistics["memory_usage_mb"] = memoryUsageMb;
+    statistics["memory_capacity_mb"] = memoryCapacityMb;
+    statistics["memory_usage_percent"] = memoryUsagePercent;
+    statistics["cpu_usage_percent"] = cpuUsagePercent;
+    return statistics;
+}
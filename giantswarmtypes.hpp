@@ -0,0 +1,96 @@
+#ifndef BIDSTACK_GIANTSWARM_TYPES_HPP
+#define BIDSTACK_GIANTSWARM_TYPES_HPP
+
+#include <QMetaType>
+#include <QString>
+#include <QVariantMap>
+#include <QVector>
+
+#include "giantswarmjsonreader.hpp"
+
+namespace Bidstack {
+    namespace Giantswarm {
+
+        /**
+         * Typed results of the status and statistics calls. All members
+         * are implicitly shared Qt values, so passing results around only
+         * copies pointers, and the structs are declared movable so that
+         * QVector relocates them without calling constructors.
+         *
+         * read() fills a struct from the object the reader is positioned
+         * on, without building a JSON document. toVariantMap() produces
+         * the maps returned by the Q_INVOKABLE methods of GiantswarmClient.
+         * ApplicationStatus and InstanceStatistics are also metatypes, so
+         * batches and replies can carry them in a QVariant.
+         */
+        struct Instance {
+            QString id;
+            QString status;
+            QString image;
+            QString createdAt;
+
+            static bool read(GiantswarmJsonReader& reader, Instance *instance);
+            QVariantMap toVariantMap() const;
+        };
+
+        struct Component {
+            Component();
+
+            QString name;
+            QString status;
+            int maximum;
+            int minimum;
+            QVector<Instance> instances;
+
+            static bool read(GiantswarmJsonReader& reader, Component *component);
+            QVariantMap toVariantMap() const;
+        };
+
+        struct Service {
+            Service();
+
+            QString name;
+            QString status;
+            int maximum;
+            int minimum;
+            QVector<Component> components;
+
+            static bool read(GiantswarmJsonReader& reader, Service *service);
+            QVariantMap toVariantMap() const;
+        };
+
+        struct ApplicationStatus {
+            QString name;
+            QString status;
+            QVector<Service> services;
+
+            static bool read(GiantswarmJsonReader& reader, ApplicationStatus *application);
+            QVariantMap toVariantMap() const;
+        };
+
+        struct InstanceStatistics {
+            InstanceStatistics();
+
+            QString component;
+            double memoryUsageMb;
+            double memoryCapacityMb;
+            double memoryUsagePercent;
+            double cpuUsagePercent;
+
+            static bool read(GiantswarmJsonReader& reader, InstanceStatistics *statistics);
+            QVariantMap toVariantMap() const;
+        };
+
+    };
+};
+
+Q_DECLARE_TYPEINFO(Bidstack::Giantswarm::Instance, Q_MOVABLE_TYPE);
+Q_DECLARE_TYPEINFO(Bidstack::Giantswarm::Component, Q_MOVABLE_TYPE);
+Q_DECLARE_TYPEINFO(Bidstack::Giantswarm::Service, Q_MOVABLE_TYPE);
+Q_DECLARE_TYPEINFO(Bidstack::Giantswarm::ApplicationStatus, Q_MOVABLE_TYPE);
+Q_DECLARE_TYPEINFO(Bidstack::Giantswarm::InstanceStatistics, Q_MOVABLE_TYPE);
+
+Q_DECLARE_METATYPE(Bidstack::Giantswarm::ApplicationStatus)
+Q_DECLARE_METATYPE(Bidstack::Giantswarm::InstanceStatistics)
+
+#endif
@@ -0,0 +1,272 @@
+#include <QHash>
+#include <QMetaObject>
+#include <QMutexLocker>
+#include <QSet>
+
+#include "giantswarmwatcher.hpp"
+#include "giantswarmclient.hpp"
+#include "giantswarmerror.hpp"
+
+using namespace Bidstack::Giantswarm;
+
+static QVariantMap componentSummary(const Component& component) {
+    QVariantMap summary;
+    summary["name"] = component.name;
+    summary["status"] = component.status;
+    summary["maximum"] = component.maximum;
+    summary["minimum"] = component.minimum;
+    return summary;
+}
+
+GiantswarmWatcher::GiantswarmWatcher(GiantswarmClient *client, QString companyName, QString environmentName, QString applicationName, int interval, QObject *parent) : QObject(parent) {
+    m_client = client;
+    m_companyName = companyName;
+    m_environmentName = environmentName;
+    m_applicationName = applicationName;
+
+    m_interval = qMax(1, interval);
+    m_maxInterval = m_interval * DEFAULT_WATCH_BACKOFF;
+    m_currentInterval = m_interval;
+    m_active = false;
+    m_hasStatus = false;
+    m_polling = false;
+    m_error = -1;
+
+    m_timer = new QTimer(this);
+    m_timer->setSingleShot(true);
+    connect(m_timer, SIGNAL(timeout()), this, SLOT(poll()));
+
+    // The watcher is run by the pool over and over again.
+    setAutoDelete(false);
+}
+
+GiantswarmWatcher::~GiantswarmWatcher() {
+    QMutexLocker locker(&m_mutex);
+    while (m_polling) {
+        m_idle.wait(&m_mutex);
+    }
+}
+
+void GiantswarmWatcher::start() {
+    if (m_active) {
+        return;
+    }
+
+    m_active = true;
+    m_currentInterval = m_interval;
+    poll();
+}
+
+void GiantswarmWatcher::stop() {
+    m_active = false;
+    m_timer->stop();
+}
+
+bool GiantswarmWatcher::isActive() const {
+    return m_active;
+}
+
+void GiantswarmWatcher::setInterval(int msecs) {
+    m_interval = qMax(1, msecs);
+    m_maxInterval = qMax(m_maxInterval, m_interval);
+}
+
+int GiantswarmWatcher::interval() const {
+    return m_interval;
+}
+
+void GiantswarmWatcher::setMaxInterval(int msecs) {
+    m_maxInterval = qMax(m_interval, msecs);
+}
+
+int GiantswarmWatcher::maxInterval() const {
+    return m_maxInterval;
+}
+
+int GiantswarmWatcher::currentInterval() const {
+    return m_currentInterval;
+}
+
+/**
+ * The most recently received status.
+ */
+ApplicationStatus GiantswarmWatcher::status() const {
+    return m_status;
+}
+
+/**
+ * Runs on a pool thread; the result is picked up by pollFinished() in
+ * the watcher's thread.
+ */
+void GiantswarmWatcher::run() {
+    ApplicationStatus status;
+    int error = -1;
+
+    m_client->resetLastError();
+
+    try {
+        bool ok = false;
+        status = m_client->applicationStatus(m_companyName, m_environmentName, m_applicationName, &ok);
+
+        if (!ok) {
+            error = m_client->lastError();
+        }
+
+        if (!ok && error < 0) {
+            error = GiantswarmError::UnexpectedResponseStatus;
+        }
+    } catch (GiantswarmError& e) {
+        error = e.error;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_result = status;
+    m_error = error;
+
+    QMetaObject::invokeMethod(this, "pollFinished", Qt::QueuedConnection);
+
+    m_polling = false;
+    m_idle.wakeAll();
+}
+
+void GiantswarmWatcher::poll() {
+    QMutexLocker locker(&m_mutex);
+
+    if (!m_active || m_polling) {
+        return;
+    }
+
+    m_polling = true;
+    locker.unlock();
+
+    m_client->startOnPool(this, GiantswarmEndpoint::ApplicationStatus);
+}
+
+void GiantswarmWatcher::pollFinished() {
+    QMutexLocker locker(&m_mutex);
+    ApplicationStatus current = m_result;
+    int error = m_error;
+    m_result = ApplicationStatus();
+    locker.unlock();
+
+    if (!m_active) {
+        return;
+    }
+
+    if (error >= 0) {
+        emit failed(error);
+        schedule(false);
+        return;
+    }
+
+    if (!m_hasStatus) {
+        m_status = current;
+        m_hasStatus = true;
+
+        emit statusReceived(current.toVariantMap());
+        schedule(true);
+        return;
+    }
+
+    ApplicationStatus previous = m_status;
+    m_status = current;
+
+    schedule(diff(previous, current));
+}
+
+bool GiantswarmWatcher::diff(const ApplicationStatus& previous, const ApplicationStatus& current) {
+    bool changed = false;
+
+    if (previous.status != current.status) {
+        emit statusChanged(current.status);
+        changed = true;
+    }
+
+    // Components are identified by their service and component name.
+    QHash<QString, Component> components;
+    foreach (const Service& service, previous.services) {
+        foreach (const Component& component, service.components) {
+            components.insert(service.name + "/" + component.name, component);
+        }
+    }
+
+    foreach (const Service& service, current.services) {
+        foreach (const Component& component, service.components) {
+            QHash<QString, Component>::iterator it = components.find(service.name + "/" + component.name);
+
+            if (it == components.end()) {
+                emit componentAdded(service.name, component.toVariantMap());
+                changed = true;
+                continue;
+            }
+
+            if (diff(service.name, it.value(), component)) {
+                changed = true;
+            }
+
+            components.erase(it);
+        }
+    }
+
+    foreach (const Service& service, previous.services) {
+        foreach (const Component& component, service.components) {
+            if (components.contains(service.name + "/" + component.name)) {
+                emit componentRemoved(service.name, component.name);
+                changed = true;
+            }
+        }
+    }
+
+    return changed;
+}
+
+bool GiantswarmWatcher::diff(QString serviceName, const Component& previous, const Component& current) {
+    bool changed = false;
+
+    if (previous.status != current.status || previous.maximum != current.maximum || previous.minimum != current.minimum) {
+        emit componentChanged(serviceName, componentSummary(current));
+        changed = true;
+    }
+
+    QHash<QString, Instance> instances;
+    foreach (const Instance& instance, previous.instances) {
+        instances.insert(instance.id, instance);
+    }
+
+    foreach (const Instance& instance, current.instances) {
+        QHash<QString, Instance>::iterator it = instances.find(instance.id);
+
+        if (it == instances.end()) {
+            emit instanceAdded(serviceName, current.name, instance.toVariantMap());
+            changed = true;
+            continue;
+        }
+
+        const Instance& before = it.value();
+        if (before.status != instance.status || before.image != instance.image || before.createdAt != instance.createdAt) {
+            emit instanceChanged(serviceName, current.name, instance.toVariantMap());
+            changed = true;
+        }
+
+        instances.erase(it);
+    }
+
+    foreach (const Instance& instance, previous.instances) {
+        if (instances.contains(instance.id)) {
+            emit instanceRemoved(serviceName, current.name, instance.id);
+            changed = true;
+        }
+    }
+
+    return changed;
+}
+
+void GiantswarmWatcher::schedule(bool changed) {
+    if (changed) {
+        m_currentInterval = m_interval;
+    } else {
+        m_currentInterval = qMin(m_maxInterval, m_currentInterval * 2);
+    }
+
+    m_timer->start(m_currentInterval);
+}
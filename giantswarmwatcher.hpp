@@ -0,0 +1,106 @@
+#ifndef BIDSTACK_GIANTSWARM_WATCHER_HPP
+#define BIDSTACK_GIANTSWARM_WATCHER_HPP
+
+#include <QMutex>
+#include <QObject>
+#include <QRunnable>
+#include <QString>
+#include <QTimer>
+#include <QVariantMap>
+#include <QWaitCondition>
+
+#include "giantswarmtypes.hpp"
+
+namespace Bidstack {
+    namespace Giantswarm {
+
+        const int DEFAULT_WATCH_INTERVAL = 5000;
+        const int DEFAULT_WATCH_BACKOFF = 8;
+
+        class GiantswarmClient;
+
+        /**
+         * Polls the status of one application on the client's thread pool
+         * and reports what changed between two polls.
+         *
+         * The first status is delivered as a whole through statusReceived().
+         * Afterwards only the application status, components and instances
+         * which were added, removed or modified are signalled. Every poll
+         * without changes, and every failed poll, doubles the interval up to
+         * maxInterval(); the first change resets it to interval().
+         *
+         * Polls are answered from the client's cache while the status cache
+         * policy considers the entry fresh.
+         */
+        class GiantswarmWatcher : public QObject, public QRunnable {
+            Q_OBJECT
+
+        public:
+            GiantswarmWatcher(GiantswarmClient *client, QString companyName, QString environmentName, QString applicationName, int interval, QObject *parent = 0);
+            ~GiantswarmWatcher();
+
+        public:
+            Q_INVOKABLE void start();
+            Q_INVOKABLE void stop();
+            Q_INVOKABLE bool isActive() const;
+
+            void setInterval(int msecs);
+            int interval() const;
+            void setMaxInterval(int msecs);
+            int maxInterval() const;
+            int currentInterval() const;
+
+            ApplicationStatus status() const;
+
+            void run();
+
+        signals:
+            void statusReceived(QVariantMap application);
+            void statusChanged(QString status);
+
+            void componentAdded(QString serviceName, QVariantMap component);
+            void componentRemoved(QString serviceName, QString componentName);
+            void componentChanged(QString serviceName, QVariantMap component);
+
+            void instanceAdded(QString serviceName, QString componentName, QVariantMap instance);
+            void instanceRemoved(QString serviceName, QString componentName, QString instanceId);
+            void instanceChanged(QString serviceName, QString componentName, QVariantMap instance);
+
+            void failed(int error);
+
+        private slots:
+            void poll();
+            void pollFinished();
+
+        private:
+            bool diff(const ApplicationStatus& previous, const ApplicationStatus& current);
+            bool diff(QString serviceName, const Component& previous, const Component& current);
+            void schedule(bool changed);
+
+        private:
+            GiantswarmClient *m_client;
+            QString m_companyName;
+            QString m_environmentName;
+            QString m_applicationName;
+
+            int m_interval;
+            int m_maxInterval;
+            int m_currentInterval;
+            QTimer *m_timer;
+            bool m_active;
+
+            bool m_hasStatus;
+            ApplicationStatus m_status;
+
+            // Handed over from the pool thread running the poll.
+            QMutex m_mutex;
+            QWaitCondition m_idle;
+            bool m_polling;
+            ApplicationStatus m_result;
+            int m_error;
+        };
+
+    };
+};
+
+#endif
@@ -0,0 +1,90 @@
+#include <QVariantList>
+
+#include "allapplicationsjob.hpp"
+
+#include "../giantswarmbatch.hpp"
+#include "../giantswarmclient.hpp"
+#include "../giantswarmreply.hpp"
+#include "../repositories/environmentrepository.hpp"
+
+using namespace Bidstack::Giantswarm;
+using namespace Bidstack::Giantswarm::Jobs;
+using namespace Bidstack::Giantswarm::Repositories;
+
+AllApplicationsJob::AllApplicationsJob(GiantswarmClient *client, EnvironmentRepository *environments, GiantswarmReply *reply, int maxInFlight) : QObject(reply) {
+    m_client = client;
+    m_environments = environments;
+    m_reply = reply;
+    m_companies = 0;
+    m_batch = 0;
+    m_maxInFlight = maxInFlight;
+}
+
+void AllApplicationsJob::start() {
+    m_companies = m_client->getCompaniesAsync();
+    connect(m_companies, SIGNAL(finished()), this, SLOT(companiesReceived()));
+}
+
+void AllApplicationsJob::companiesReceived() {
+    QVariantList companies = m_companies->toList();
+    int error = m_companies->hasError() ? (int) m_companies->error() : -1;
+
+    m_companies->deleteLater();
+    m_companies = 0;
+
+    if (companies.isEmpty()) {
+        finish(QVariantList(), error);
+        return;
+    }
+
+    createBatch(companies);
+    connect(m_batch, SIGNAL(finished()), this, SLOT(applicationsReceived()));
+
+    m_batch->start();
+}
+
+void AllApplicationsJob::applicationsReceived() {
+    finish(merge(), m_batch->error());
+}
+
+QVariantList AllApplicationsJob::run() {
+    QVariantList companies = m_client->getCompanies();
+
+    if (companies.isEmpty()) {
+        return QVariantList();
+    }
+
+    createBatch(companies);
+    m_batch->run();
+
+    return merge();
+}
+
+void AllApplicationsJob::createBatch(QVariantList companies) {
+    m_batch = new GiantswarmBatch(m_client, m_maxInFlight, this);
+
+    // Environments are read in this thread, as the database connection
+    // cannot be used from the pool threads running the requests.
+    foreach (QVariant company, companies) {
+        QString companyName = company.toString();
+
+        foreach (QVariant environment, m_environments->all(companyName)) {
+            m_batch->add(GiantswarmEndpoint::Applications, "getApplications", "QVariantList", QVariantList() << companyName << environment.toString());
+        }
+    }
+}
+
+QVariantList AllApplicationsJob::merge() const {
+    QVariantList applications;
+
+    foreach (QVariant result, m_batch->results()) {
+        applications.append(result.toList());
+    }
+
+    return applications;
+}
+
+void AllApplicationsJob::finish(QVariant result, int error) {
+    m_reply->complete(result, error);
+    deleteLater();
+}
@@ -0,0 +1,62 @@
+#ifndef BIDSTACK_GIANTSWARM_ALLAPPLICATIONSJOB_HPP
+#define BIDSTACK_GIANTSWARM_ALLAPPLICATIONSJOB_HPP
+
+#include <QObject>
+#include <QVariant>
+#include <QVariantList>
+
+namespace Bidstack {
+    namespace Giantswarm {
+
+        class GiantswarmBatch;
+        class GiantswarmClient;
+        class GiantswarmReply;
+
+        namespace Repositories {
+            class EnvironmentRepository;
+        };
+
+        namespace Jobs {
+
+            /**
+             * Fetches the companies of the current user and then the
+             * applications of every environment known for each of them,
+             * merging the results in company and environment order.
+             *
+             * start() completes the reply through the calling thread's
+             * event loop; run() blocks and returns the result instead.
+             */
+            class AllApplicationsJob : public QObject {
+                Q_OBJECT
+
+            public:
+                AllApplicationsJob(GiantswarmClient *client, Repositories::EnvironmentRepository *environments, GiantswarmReply *reply, int maxInFlight);
+
+            public:
+                void start();
+                QVariantList run();
+
+            private slots:
+                void companiesReceived();
+                void applicationsReceived();
+
+            private:
+                void createBatch(QVariantList companies);
+                QVariantList merge() const;
+                void finish(QVariant result, int error);
+
+            private:
+                GiantswarmClient *m_client;
+                Repositories::EnvironmentRepository *m_environments;
+                GiantswarmReply *m_reply;
+                GiantswarmReply *m_companies;
+                GiantswarmBatch *m_batch;
+                int m_maxInFlight;
+            };
+
+        };
+
+    };
+};
+
+#endif
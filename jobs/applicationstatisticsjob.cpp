@@ -0,0 +1,175 @@
+#include <QtAlgorithms>
+#include <QVariantList>
+
+#include "applicationstatisticsjob.hpp"
+
+#include "../giantswarmbatch.hpp"
+#include "../giantswarmclient.hpp"
+#include "../giantswarmreply.hpp"
+
+using namespace Bidstack::Giantswarm;
+using namespace Bidstack::Giantswarm::Jobs;
+
+/**
+ * Keys of the aggregated metrics, in the order merge() collects them.
+ */
+static const char *METRICS[] = {
+    "cpu_usage_percent",
+    "memory_usage_mb",
+    "memory_usage_percent"
+};
+
+static const int METRICS_COUNT = sizeof(METRICS) / sizeof(METRICS[0]);
+
+ApplicationStatisticsJob::ApplicationStatisticsJob(GiantswarmClient *client, QString companyName, QString environmentName, QString applicationName, GiantswarmReply *reply, int maxInFlight) : QObject(reply) {
+    m_client = client;
+    m_companyName = companyName;
+    m_environmentName = environmentName;
+    m_applicationName = applicationName;
+    m_reply = reply;
+    m_status = 0;
+    m_batch = 0;
+    m_maxInFlight = maxInFlight;
+}
+
+void ApplicationStatisticsJob::start() {
+    m_status = m_client->applicationStatusAsync(m_companyName, m_environmentName, m_applicationName);
+    connect(m_status, SIGNAL(finished()), this, SLOT(statusReceived()));
+}
+
+void ApplicationStatisticsJob::statusReceived() {
+    ApplicationStatus application = m_status->result().value<ApplicationStatus>();
+    int error = m_status->hasError() ? (int) m_status->error() : -1;
+
+    m_status->deleteLater();
+    m_status = 0;
+
+    if (error >= 0) {
+        finish(QVariantMap(), error);
+        return;
+    }
+
+    createBatch(application);
+    connect(m_batch, SIGNAL(finished()), this, SLOT(statisticsReceived()));
+
+    m_batch->start();
+}
+
+void ApplicationStatisticsJob::statisticsReceived() {
+    finish(merge(), m_batch->error());
+}
+
+QVariantMap ApplicationStatisticsJob::run() {
+    bool ok;
+    ApplicationStatus application = m_client->applicationStatus(m_companyName, m_environmentName, m_applicationName, &ok);
+
+    if (!ok) {
+        return QVariantMap();
+    }
+
+    createBatch(application);
+    m_batch->run();
+
+    return merge();
+}
+
+void ApplicationStatisticsJob::createBatch(const ApplicationStatus& application) {
+    m_batch = new GiantswarmBatch(m_client, m_maxInFlight, this);
+
+    foreach (const Service& service, application.services) {
+        foreach (const Component& component, service.components) {
+            Entry entry;
+            entry.service = service.name;
+            entry.component = component.name;
+
+            foreach (const Instance& instance, component.instances) {
+                entry.instances.append(instance.id);
+                m_batch->add(GiantswarmEndpoint::InstanceStatistics, "instanceStatistics", "InstanceStatistics", QVariantList() << m_companyName << instance.id);
+            }
+
+            m_entries.append(entry);
+        }
+    }
+}
+
+QVariantMap ApplicationStatisticsJob::merge() const {
+    QVariantList results = m_batch->results();
+    QVariantList components;
+    int next = 0;
+
+    foreach (const Entry& entry, m_entries) {
+        QVariantList instances;
+        QList<double> values[METRICS_COUNT];
+
+        foreach (QString instanceId, entry.instances) {
+            QVariant result = results.at(next++);
+            QVariantMap instance;
+
+            // Instances whose statistics could not be fetched are listed
+            // but left out of the aggregates.
+            if (result.isValid()) {
+                InstanceStatistics statistics = result.value<InstanceStatistics>();
+
+                values[0].append(statistics.cpuUsagePercent);
+                values[1].append(statistics.memoryUsageMb);
+                values[2].append(statistics.memoryUsagePercent);
+
+                instance = statistics.toVariantMap();
+            }
+
+            instance["id"] = instanceId;
+            instances.append(instance);
+        }
+
+        QVariantMap component;
+        component["service"] = entry.service;
+        component["name"] = entry.component;
+        component["instances"] = instances;
+
+        for (int i = 0; i < METRICS_COUNT; ++i) {
+            component[METRICS[i]] = aggregate(values[i]);
+        }
+
+        components.append(component);
+    }
+
+    QVariantMap application;
+    application["name"] = m_applicationName;
+    application["components"] = components;
+
+    return application;
+}
+
+/**
+ * The 95th percentile uses the nearest-rank method.
+ */
+QVariantMap ApplicationStatisticsJob::aggregate(QList<double> values) {
+    QVariantMap aggregate;
+    aggregate["sum"] = 0.0;
+    aggregate["mean"] = 0.0;
+    aggregate["p95"] = 0.0;
+
+    if (values.isEmpty()) {
+        return aggregate;
+    }
+
+    qSort(values);
+
+    double sum = 0;
+    foreach (double value, values) {
+        sum += value;
+    }
+
+    int rank = (95 * values.size() + 99) / 100;
+
+    aggregate["sum"] = sum;
+    aggregate["mean"] = sum / values.size();
+    aggregate["p95"] = values.at(qMax(0, rank - 1));
+
+    return aggregate;
+}
+
+void ApplicationStatisticsJob::finish(QVariant result, int error) {
+    m_reply->complete(result, error);
+    deleteLater();
+}
@@ -0,0 +1,75 @@
+#ifndef BIDSTACK_GIANTSWARM_APPLICATIONSTATISTICSJOB_HPP
+#define BIDSTACK_GIANTSWARM_APPLICATIONSTATISTICSJOB_HPP
+
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVariantMap>
+
+#include "../giantswarmtypes.hpp"
+
+namespace Bidstack {
+    namespace Giantswarm {
+
+        class GiantswarmBatch;
+        class GiantswarmClient;
+        class GiantswarmReply;
+
+        namespace Jobs {
+
+            /**
+             * Fetches the status of an application and then the statistics
+             * of all of its instances, at most maxInFlight at a time. The
+             * result lists every component with its instances' statistics
+             * and the sum, mean and 95th percentile of each metric.
+             *
+             * start() completes the reply through the calling thread's
+             * event loop; run() blocks and returns the result instead.
+             */
+            class ApplicationStatisticsJob : public QObject {
+                Q_OBJECT
+
+            public:
+                ApplicationStatisticsJob(GiantswarmClient *client, QString companyName, QString environmentName, QString applicationName, GiantswarmReply *reply, int maxInFlight);
+
+            public:
+                void start();
+                QVariantMap run();
+
+            private slots:
+                void statusReceived();
+                void statisticsReceived();
+
+            private:
+                void createBatch(const ApplicationStatus& application);
+                QVariantMap merge() const;
+                static QVariantMap aggregate(QList<double> values);
+                void finish(QVariant result, int error);
+
+            private:
+                struct Entry {
+                    QString service;
+                    QString component;
+                    QStringList instances;
+                };
+
+                GiantswarmClient *m_client;
+                QString m_companyName;
+                QString m_environmentName;
+                QString m_applicationName;
+                GiantswarmReply *m_reply;
+                GiantswarmReply *m_status;
+                GiantswarmBatch *m_batch;
+                int m_maxInFlight;
+
+                QList<Entry> m_entries;
+            };
+
+        };
+
+    };
+};
+
+#endif
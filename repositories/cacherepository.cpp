@@ -0,0 +1,314 @@
+#include <QDebug>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+
+#include "cacherepository.hpp"
+
+using namespace Bidstack::Giantswarm::Repositories;
+
+CacheRepository::CacheRepository(QSqlDatabase& database, QObject *parent) : GiantswarmRepository(database, parent) {
+    m_maxSize = DEFAULT_CACHE_MAX_SIZE;
+    m_size = 0;
+    init();
+}
+
+bool CacheRepository::fetch(QString key, qint64 now, QString *value) {
+    const QString sql =
+      "SELECT value FROM cache_entries WHERE "
+        "key = :key AND "
+        "expires_at > :now";
+
+    QSqlQuery& stmt = statement(sql);
+    stmt.bindValue(":key", key);
+    stmt.bindValue(":now", now);
+    stmt.exec();
+
+    QSqlError err = stmt.lastError();
+    if (err.isValid()) {
+        qWarning() << "Failed to fetch cache entry:" << err.text();
+        stmt.finish();
+        return false;
+    }
+
+    bool found = stmt.next();
+    if (found) {
+        *value = stmt.value(0).toString();
+    }
+
+    stmt.finish();
+    return found;
+}
+
+bool CacheRepository::has(QString key, qint64 now) {
+    const QString sql =
+      "SELECT 1 FROM cache_entries WHERE "
+        "key = :key AND "
+        "expires_at > :now";
+
+    QSqlQuery& stmt = statement(sql);
+    stmt.bindValue(":key", key);
+    stmt.bindValue(":now", now);
+    stmt.exec();
+
+    bool found = !stmt.lastError().isValid() && stmt.next();
+    stmt.finish();
+
+    return found;
+}
+
+/**
+ * Stores the given values and marks the accessed keys as used at now,
+ * all in one transaction. Expired entries are purged and the least
+ * recently used ones evicted if the cache grew beyond its maximum size.
+ */
+bool CacheRepository::write(QMap<QString, QString> values, qint64 expiresAt, QSet<QString> accessed, qint64 now) {
+    const QString insert =
+      "INSERT OR REPLACE INTO cache_entries (key, value, size, expires_at, accessed_at) "
+        "VALUES (:key, :value, :size, :expires_at, :accessed_at)";
+
+    const QString touch =
+      "UPDATE cache_entries SET accessed_at = :accessed_at WHERE key = :key";
+
+    const QString previous =
+      "SELECT size FROM cache_entries WHERE key = :key";
+
+    if (!database().transaction()) {
+        qWarning() << "Failed to begin transaction:" << database().lastError().text();
+        return false;
+    }
+
+    // The running total only takes the changes once they are committed.
+    qint64 size = m_size;
+
+    QSqlQuery& previousStmt = statement(previous);
+    QSqlQuery& insertStmt = statement(insert);
+
+    QMap<QString, QString>::const_iterator it;
+    for (it = values.constBegin(); it != values.constEnd(); ++it) {
+        qint64 entrySize = it.key().toUtf8().size() + it.value().toUtf8().size();
+
+        previousStmt.bindValue(":key", it.key());
+        previousStmt.exec();
+
+        if (!previousStmt.lastError().isValid() && previousStmt.next()) {
+            size -= previousStmt.value(0).toLongLong();
+        }
+
+        previousStmt.finish();
+
+        insertStmt.bindValue(":key", it.key());
+        insertStmt.bindValue(":value", it.value());
+        insertStmt.bindValue(":size", entrySize);
+        insertStmt.bindValue(":expires_at", expiresAt);
+        insertStmt.bindValue(":accessed_at", now);
+        insertStmt.exec();
+
+        QSqlError err = insertStmt.lastError();
+        insertStmt.finish();
+
+        if (err.isValid()) {
+            qWarning() << "Failed to store cache entry:" << err.text();
+            database().rollback();
+            return false;
+        }
+
+        size += entrySize;
+    }
+
+    QSqlQuery& touchStmt = statement(touch);
+
+    foreach (QString key, accessed) {
+        if (values.contains(key)) {
+            continue;
+        }
+
+        touchStmt.bindValue(":accessed_at", now);
+        touchStmt.bindValue(":key", key);
+        touchStmt.exec();
+
+        QSqlError err = touchStmt.lastError();
+        touchStmt.finish();
+
+        if (err.isValid()) {
+            qWarning() << "Failed to update cache entry:" << err.text();
+            database().rollback();
+            return false;
+        }
+    }
+
+    if (!purge(now, &size) || !evict(&size)) {
+        database().rollback();
+        return false;
+    }
+
+    if (!database().commit()) {
+        qWarning() << "Failed to commit cache entries:" << database().lastError().text();
+        database().rollback();
+        return false;
+    }
+
+    m_size = size;
+    return true;
+}
+
+bool CacheRepository::clear() {
+    const QString sql = "DELETE FROM cache_entries";
+
+    QSqlQuery& stmt = statement(sql);
+    stmt.exec();
+
+    QSqlError err = stmt.lastError();
+    stmt.finish();
+
+    if (err.isValid()) {
+        qWarning() << "Failed to clear cache entries:" << err.text();
+        return false;
+    }
+
+    m_size = 0;
+    return true;
+}
+
+/**
+ * Total size in bytes of all entries, counting keys and values by their
+ * UTF-8 length, as SQLite stores them. 0 disables eviction.
+ */
+void CacheRepository::setMaxSize(qint64 bytes) {
+    m_maxSize = qMax((qint64) 0, bytes);
+}
+
+qint64 CacheRepository::maxSize() const {
+    return m_maxSize;
+}
+
+void CacheRepository::init() {
+    const QString sql =
+        "CREATE TABLE IF NOT EXISTS cache_entries ("
+            "key TEXT PRIMARY KEY NOT NULL, "
+            "value TEXT NOT NULL, "
+            "size INTEGER NOT NULL, "
+            "expires_at INTEGER NOT NULL, "
+            "accessed_at INTEGER NOT NULL"
+        ")";
+
+    QSqlQuery stmt(database());
+    stmt.exec(sql);
+
+    QSqlError err = stmt.lastError();
+    if (err.isValid()) {
+        qWarning() << "Failed to create cache_entries table:" << err.text();
+        return;
+    }
+
+    QStringList indexes;
+    indexes << "CREATE INDEX IF NOT EXISTS cache_entries_expires_at ON cache_entries (expires_at)";
+    indexes << "CREATE INDEX IF NOT EXISTS cache_entries_accessed_at ON cache_entries (accessed_at)";
+
+    foreach (QString index, indexes) {
+        QSqlQuery indexStmt(database());
+        indexStmt.exec(index);
+
+        err = indexStmt.lastError();
+        if (err.isValid()) {
+            qWarning() << "Failed to create cache_entries index:" << err.text();
+        }
+    }
+
+    QSqlQuery sizeStmt(database());
+    sizeStmt.exec("SELECT COALESCE(SUM(size), 0) FROM cache_entries");
+
+    if (!sizeStmt.lastError().isValid() && sizeStmt.next()) {
+        m_size = sizeStmt.value(0).toLongLong();
+    }
+}
+
+bool CacheRepository::purge(qint64 now, qint64 *size) {
+    const QString expired =
+      "SELECT COALESCE(SUM(size), 0) FROM cache_entries WHERE expires_at <= :now";
+
+    const QString sql = "DELETE FROM cache_entries WHERE expires_at <= :now";
+
+    QSqlQuery& expiredStmt = statement(expired);
+    expiredStmt.bindValue(":now", now);
+    expiredStmt.exec();
+
+    qint64 purged = 0;
+    if (!expiredStmt.lastError().isValid() && expiredStmt.next()) {
+        purged = expiredStmt.value(0).toLongLong();
+    }
+
+    expiredStmt.finish();
+
+    if (purged == 0) {
+        return true;
+    }
+
+    QSqlQuery& stmt = statement(sql);
+    stmt.bindValue(":now", now);
+    stmt.exec();
+
+    QSqlError err = stmt.lastError();
+    stmt.finish();
+
+    if (err.isValid()) {
+        qWarning() << "Failed to purge cache entries:" << err.text();
+        return false;
+    }
+
+    *size -= purged;
+    return true;
+}
+
+/**
+ * Deletes the least recently used entries until the total size is within
+ * the budget again.
+ */
+bool CacheRepository::evict(qint64 *size) {
+    if (m_maxSize <= 0) {
+        return true;
+    }
+
+    qint64 excess = *size - m_maxSize;
+    if (excess <= 0) {
+        return true;
+    }
+
+    const QString select =
+      "SELECT key, size FROM cache_entries "
+        "ORDER BY accessed_at ASC";
+
+    QStringList keys;
+
+    QSqlQuery& selectStmt = statement(select);
+    selectStmt.exec();
+
+    QList<qint64> sizes;
+
+    while (excess > 0 && selectStmt.next()) {
+        keys.append(selectStmt.value(0).toString());
+        sizes.append(selectStmt.value(1).toLongLong());
+        excess -= sizes.last();
+    }
+
+    selectStmt.finish();
+
+    QSqlQuery& deleteStmt = statement("DELETE FROM cache_entries WHERE key = :key");
+
+    for (int i = 0; i < keys.size(); ++i) {
+        deleteStmt.bindValue(":key", keys.at(i));
+        deleteStmt.exec();
+
+        QSqlError err = deleteStmt.lastError();
+        deleteStmt.finish();
+
+        if (err.isValid()) {
+            qWarning() << "Failed to evict cache entry:" << err.text();
+            return false;
+        }
+
+        *size -= sizes.at(i);
+    }
+
+    return true;
+}
@@ -0,0 +1,62 @@
+#ifndef BIDSTACK_GIANTSWARM_CACHEREPOSITORY_HPP
+#define BIDSTACK_GIANTSWARM_CACHEREPOSITORY_HPP
+
+#include <QMap>
+#include <QObject>
+#include <QSet>
+#include <QString>
+
+#include "../giantswarmrepository.hpp"
+
+namespace Bidstack {
+    namespace Giantswarm {
+
+        namespace Repositories {
+
+            const qint64 DEFAULT_CACHE_MAX_SIZE = 64 * 1024 * 1024;
+
+            /**
+             * Cache entries keyed by their cache key. Every entry records
+             * when it expires, when it was last read and its size, so that
+             * expired entries can be purged and the least recently used
+             * ones evicted once the total size exceeds the budget.
+             *
+             * The total size is read from the table once and then kept up to
+             * date by write() and clear(), which must not run concurrently;
+             * writes by other processes are only counted after a restart.
+             *
+             * Times are milliseconds since the epoch.
+             */
+            class CacheRepository : public GiantswarmRepository {
+                Q_OBJECT
+
+            public:
+                CacheRepository(QSqlDatabase& database, QObject *parent = 0);
+
+            public:
+                bool fetch(QString key, qint64 now, QString *value);
+                bool has(QString key, qint64 now);
+                bool write(QMap<QString, QString> values, qint64 expiresAt, QSet<QString> accessed, qint64 now);
+                bool clear();
+
+                void setMaxSize(qint64 bytes);
+                qint64 maxSize() const;
+
+            protected:
+                void init();
+
+            private:
+                bool purge(qint64 now, qint64 *size);
+                bool evict(qint64 *size);
+
+            private:
+                qint64 m_maxSize;
+                qint64 m_size;
+            };
+
+        };
+
+    };
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include <QDebug>
+#include <QtAlgorithms>
 #include <QSqlQuery>
 #include <QSqlError>
 
@@ -7,31 +8,177 @@
 using namespace Bidstack::Giantswarm::Repositories;
 
 EnvironmentRepository::EnvironmentRepository(QSqlDatabase& database, QObject *parent) : GiantswarmRepository(database, parent) {
+    m_syncInterval = DEFAULT_ENVIRONMENT_SYNC_INTERVAL;
+    m_indexVersion = 0;
     init();
 }
 
 bool EnvironmentRepository::add(QString companyName, QString environmentName) {
     const QString sql =
-      "INSERT INTO environments (company_name, name) "
+      "INSERT OR IGNORE INTO environments (company_name, name) "
         "VALUES (:company_name, :environment_name)";
 
-    QSqlQuery stmt(database());
-    stmt.prepare(sql);
+    QSqlQuery& stmt = statement(sql);
     stmt.bindValue(":company_name", companyName);
     stmt.bindValue(":environment_name", environmentName);
     stmt.exec();
 
     QSqlError err = stmt.lastError();
+    stmt.finish();
+
     if (err.isValid()) {
         qWarning() << "Failed to add environment:" << err.text();
         return false;
     }
 
+    QWriteLocker locker(&m_indexLock);
+    ++m_indexVersion;
+    QStringList& environments = m_index[companyName];
+    QStringList::iterator it = qLowerBound(environments.begin(), environments.end(), environmentName);
+    if (it == environments.end() || *it != environmentName) {
+        environments.insert(it, environmentName);
+    }
+
+    return true;
+}
+
+/**
+ * Adds all given environments in a single transaction. If given, added
+ * receives one entry per name telling whether it was newly added (true)
+ * or already present (false). Nothing is written if any insert fails.
+ */
+bool EnvironmentRepository::addMany(QString companyName, QStringList environmentNames, QList<bool> *added) {
+    if (!database().transaction()) {
+        qWarning() << "Failed to begin transaction:" << database().lastError().text();
+        return false;
+    }
+
+    QList<bool> results;
+    if (!insertMany(companyName, environmentNames, &results)) {
+        database().rollback();
+        return false;
+    }
+
+    if (!database().commit()) {
+        qWarning() << "Failed to commit environments:" << database().lastError().text();
+        database().rollback();
+        return false;
+    }
+
+    QWriteLocker locker(&m_indexLock);
+    ++m_indexVersion;
+    QStringList& environments = m_index[companyName];
+    for (int i = 0; i < environmentNames.size(); ++i) {
+        if (results.at(i)) {
+            environments.append(environmentNames.at(i));
+        }
+    }
+    environments.sort();
+
+    if (added) {
+        *added = results;
+    }
+
+    return true;
+}
+
+/**
+ * Makes the given names the only environments of the company, in a
+ * single transaction. added is filled as for addMany().
+ */
+bool EnvironmentRepository::replaceAll(QString companyName, QStringList environmentNames, QList<bool> *added) {
+    const QString select =
+      "SELECT name FROM environments WHERE "
+        "company_name = :company_name";
+
+    const QString sql =
+      "DELETE FROM environments WHERE "
+        "company_name = :company_name AND "
+        "name = :environment_name";
+
+    if (!database().transaction()) {
+        qWarning() << "Failed to begin transaction:" << database().lastError().text();
+        return false;
+    }
+
+    // The rows to delete are read from the table inside the transaction,
+    // as the index may not have seen rows added by other processes yet.
+    QSqlQuery& selectStmt = statement(select);
+    selectStmt.bindValue(":company_name", companyName);
+    selectStmt.exec();
+
+    QStringList existing;
+    while (selectStmt.next()) {
+        existing.append(selectStmt.value(0).toString());
+    }
+
+    QSqlError selectErr = selectStmt.lastError();
+    selectStmt.finish();
+
+    if (selectErr.isValid()) {
+        qWarning() << "Failed to read environments:" << selectErr.text();
+        database().rollback();
+        return false;
+    }
+
+    QSqlQuery& stmt = statement(sql);
+
+    foreach (QString environmentName, existing) {
+        if (environmentNames.contains(environmentName)) {
+            continue;
+        }
+
+        stmt.bindValue(":company_name", companyName);
+        stmt.bindValue(":environment_name", environmentName);
+        stmt.exec();
+
+        QSqlError err = stmt.lastError();
+        stmt.finish();
+
+        if (err.isValid()) {
+            qWarning() << "Failed to remove environment:" << err.text();
+            database().rollback();
+            return false;
+        }
+    }
+
+    QList<bool> results;
+    if (!insertMany(companyName, environmentNames, &results)) {
+        database().rollback();
+        return false;
+    }
+
+    if (!database().commit()) {
+        qWarning() << "Failed to commit environments:" << database().lastError().text();
+        database().rollback();
+        return false;
+    }
+
+    QStringList environments = environmentNames;
+    environments.removeDuplicates();
+    environments.sort();
+
+    QWriteLocker locker(&m_indexLock);
+    ++m_indexVersion;
+    if (environments.isEmpty()) {
+        m_index.remove(companyName);
+    } else {
+        m_index[companyName] = environments;
+    }
+
+    if (added) {
+        *added = results;
+    }
+
     return true;
 }
 
 bool EnvironmentRepository::has(QString companyName, QString environmentName) {
-    return all(companyName).contains(environmentName);
+    sync();
+
+    QReadLocker locker(&m_indexLock);
+    QStringList environments = m_index.value(companyName);
+    return qBinaryFind(environments.begin(), environments.end(), environmentName) != environments.end();
 }
 
 bool EnvironmentRepository::remove(QString companyName, QString environmentName) {
@@ -40,18 +187,29 @@ bool EnvironmentRepository::remove(QString companyName, QString environmentName)
         "company_name = :company_name AND "
         "name = :environment_name";
 
-    QSqlQuery stmt(database());
-    stmt.prepare(sql);
+    QSqlQuery& stmt = statement(sql);
     stmt.bindValue(":company_name", companyName);
     stmt.bindValue(":environment_name", environmentName);
     stmt.exec();
 
     QSqlError err = stmt.lastError();
+    stmt.finish();
+
     if (err.isValid()) {
         qWarning() << "Failed to remove environment:" << err.text();
         return false;
     }
 
+    QWriteLocker locker(&m_indexLock);
+    ++m_indexVersion;
+    if (m_index.contains(companyName)) {
+        m_index[companyName].removeAll(environmentName);
+
+        if (m_index[companyName].isEmpty()) {
+            m_index.remove(companyName);
+        }
+    }
+
     return true;
 }
 
@@ -60,85 +218,85 @@ bool EnvironmentRepository::clear(QString companyName) {
       "DELETE FROM environments WHERE "
         "company_name = :company_name";
 
-    QSqlQuery stmt(database());
-    stmt.prepare(sql);
+    QSqlQuery& stmt = statement(sql);
     stmt.bindValue(":company_name", companyName);
     stmt.exec();
 
     QSqlError err = stmt.lastError();
+    stmt.finish();
+
     if (err.isValid()) {
         qWarning() << "Failed to clear environments:" << err.text();
         return false;
     }
 
+    QWriteLocker locker(&m_indexLock);
+    ++m_indexVersion;
+    m_index.remove(companyName);
     return true;
 }
 
 bool EnvironmentRepository::clear() {
     const QString sql = "DELETE FROM environments";
 
-    QSqlQuery stmt(database());
-    stmt.prepare(sql);
+    QSqlQuery& stmt = statement(sql);
     stmt.exec();
 
     QSqlError err = stmt.lastError();
+    stmt.finish();
+
     if (err.isValid()) {
         qWarning() << "Failed to clear environments:" << err.text();
         return false;
     }
 
+    QWriteLocker locker(&m_indexLock);
+    ++m_indexVersion;
+    m_index.clear();
     return true;
 }
 
 QVariantList EnvironmentRepository::all(QString companyName) {
-    const QString sql =
-      "SELECT name FROM environments WHERE "
-        "company_name = :company_name "
-        "ORDER BY name ASC";
+    sync();
 
-    QSqlQuery stmt(database());
-    stmt.prepare(sql);
-    stmt.bindValue(":company_name", companyName);
-    stmt.exec();
-
-    QSqlError err = stmt.lastError();
-    if (err.isValid()) {
-        return QVariantList();
-    }
+    QReadLocker locker(&m_indexLock);
 
     QVariantList environments;
-    while (stmt.next()) {
-        environments.append(stmt.value(0).toString());
+    foreach (QString environmentName, m_index.value(companyName)) {
+        environments.append(environmentName);
     }
 
     return environments;
 }
 
 QVariantList EnvironmentRepository::all() {
-    const QString sql =
-      "SELECT name, company_name FROM environments "
-        "ORDER BY company_name ASC, name ASC";
+    sync();
 
-    QSqlQuery stmt(database());
-    stmt.prepare(sql);
-    stmt.exec();
-
-    QSqlError err = stmt.lastError();
-    if (err.isValid()) {
-        return QVariantList();
-    }
+    QReadLocker locker(&m_indexLock);
 
     QVariantList environments;
-    while (stmt.next()) {
-        QVariantMap environment;
-        environment["name"] = stmt.value(0).toString();
-        environment["company_name"] = stmt.value(1).toString();
-        environments.append(environment);
+
+    QMap<QString, QStringList>::const_iterator it;
+    for (it = m_index.constBegin(); it != m_index.constEnd(); ++it) {
+        foreach (QString environmentName, it.value()) {
+            QVariantMap environment;
+            environment["name"] = environmentName;
+            environment["company_name"] = it.key();
+            environments.append(environment);
+        }
     }
 
     return environments;
 }
 
+/**
+ * With an interval of 0 the database is checked for outside changes on
+ * every read.
+ */
+void EnvironmentRepository::setSyncInterval(int msecs) {
+    m_syncInterval = qMax(0, msecs);
+}
+
 void EnvironmentRepository::init() {
     const QString sql =
         "CREATE TABLE IF NOT EXISTS environments ("
@@ -153,5 +311,151 @@ void EnvironmentRepository::init() {
     QSqlError err = stmt.lastError();
     if (err.isValid()) {
         qWarning() << "Failed to create environments table:" << err.text();
+        return;
+    }
+
+    // Databases created before the unique index existed may contain
+    // duplicate rows, which would prevent creating it.
+    const QString dedupe =
+        "DELETE FROM environments WHERE id NOT IN ("
+            "SELECT MIN(id) FROM environments GROUP BY company_name, name"
+        ")";
+
+    QSqlQuery dedupeStmt(database());
+    dedupeStmt.exec(dedupe);
+
+    err = dedupeStmt.lastError();
+    if (err.isValid()) {
+        qWarning() << "Failed to remove duplicate environments:" << err.text();
+    }
+
+    const QString index =
+        "CREATE UNIQUE INDEX IF NOT EXISTS environments_company_name_name "
+            "ON environments (company_name, name)";
+
+    QSqlQuery indexStmt(database());
+    indexStmt.exec(index);
+
+    err = indexStmt.lastError();
+    if (err.isValid()) {
+        qWarning() << "Failed to create environments index:" << err.text();
+    }
+
+    load();
+}
+
+bool EnvironmentRepository::insertMany(QString companyName, QStringList environmentNames, QList<bool> *added) {
+    const QString sql =
+      "INSERT OR IGNORE INTO environments (company_name, name) "
+        "VALUES (:company_name, :environment_name)";
+
+    QSqlQuery& stmt = statement(sql);
+
+    foreach (QString environmentName, environmentNames) {
+        stmt.bindValue(":company_name", companyName);
+        stmt.bindValue(":environment_name", environmentName);
+        stmt.exec();
+
+        QSqlError err = stmt.lastError();
+        int rows = stmt.numRowsAffected();
+        stmt.finish();
+
+        if (err.isValid()) {
+            qWarning() << "Failed to add environment:" << err.text();
+            return false;
+        }
+
+        added->append(rows > 0);
     }
+
+    return true;
+}
+
+/**
+ * Replaces the index with the table's contents. A write made through
+ * another thread while the table was read may be missing from what was
+ * read, so the index is only replaced if no write went through it in the
+ * meantime; otherwise the table is read again.
+ */
+void EnvironmentRepository::load() {
+    const QString sql =
+      "SELECT name, company_name FROM environments "
+        "ORDER BY company_name ASC, name ASC";
+
+    SyncState *state = syncState();
+    state->lastSync.start();
+
+    for (int attempt = 0; attempt < ENVIRONMENT_LOAD_ATTEMPTS; ++attempt) {
+        m_indexLock.lockForRead();
+        quint64 indexVersion = m_indexVersion;
+        m_indexLock.unlock();
+
+        qint64 version = dataVersion();
+
+        QSqlQuery& stmt = statement(sql);
+        stmt.exec();
+
+        QSqlError err = stmt.lastError();
+        if (err.isValid()) {
+            qWarning() << "Failed to load environments:" << err.text();
+            stmt.finish();
+            return;
+        }
+
+        QMap<QString, QStringList> index;
+        while (stmt.next()) {
+            index[stmt.value(1).toString()].append(stmt.value(0).toString());
+        }
+
+        stmt.finish();
+
+        QWriteLocker locker(&m_indexLock);
+        if (m_indexVersion == indexVersion) {
+            m_index = index;
+            state->dataVersion = version;
+            return;
+        }
+    }
+
+    // Keeps the written-through index and retries with the next sync.
+    state->dataVersion = -1;
+}
+
+void EnvironmentRepository::sync() {
+    SyncState *state = syncState();
+
+    if (state->lastSync.isValid() && state->lastSync.elapsed() < m_syncInterval) {
+        return;
+    }
+
+    state->lastSync.start();
+
+    // data_version only changes for commits made by other connections,
+    // so writes through this thread's connection do not trigger a reload.
+    if (dataVersion() != state->dataVersion) {
+        load();
+    }
+}
+
+EnvironmentRepository::SyncState* EnvironmentRepository::syncState() {
+    if (!m_syncStates.hasLocalData()) {
+        SyncState *state = new SyncState();
+        state->dataVersion = -1;
+        m_syncStates.setLocalData(state);
+    }
+
+    return m_syncStates.localData();
+}
+
+qint64 EnvironmentRepository::dataVersion() {
+    QSqlQuery& stmt = statement("PRAGMA data_version");
+    stmt.exec();
+
+    qint64 version = -1;
+    if (!stmt.lastError().isValid() && stmt.next()) {
+        version = stmt.value(0).toLongLong();
+    }
+
+    stmt.finish();
+    return version;
 }
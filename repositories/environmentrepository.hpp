@@ -1,7 +1,13 @@
 #ifndef BIDSTACK_GIANTSWARM_ENVIRONMENTREPOSITORY_HPP
 #define BIDSTACK_GIANTSWARM_ENVIRONMENTREPOSITORY_HPP
 
+#include <QElapsedTimer>
+#include <QList>
+#include <QMap>
 #include <QObject>
+#include <QReadWriteLock>
+#include <QStringList>
+#include <QThreadStorage>
 #include <QVariantList>
 
 #include "../giantswarmrepository.hpp"
@@ -11,6 +17,21 @@ namespace Bidstack {
 
         namespace Repositories {
 
+            const int DEFAULT_ENVIRONMENT_SYNC_INTERVAL = 1000;
+            const int ENVIRONMENT_LOAD_ATTEMPTS = 3;
+
+            /**
+             * Environments are read from an in-memory index which is loaded
+             * on construction and updated on every write. Changes made to the
+             * database through other connections are picked up by comparing
+             * PRAGMA data_version, at most once per sync interval.
+             *
+             * The index is shared by all threads and guarded by a
+             * read-write lock; each thread queries the database through
+             * its own connection and checks its data_version on its own.
+             * Every write through the index bumps its version, so a reload
+             * never replaces it with a read that missed such a write.
+             */
             class EnvironmentRepository : public GiantswarmRepository {
                 Q_OBJECT
 
@@ -19,6 +40,8 @@ namespace Bidstack {
 
             public:
                 bool add(QString companyName, QString environmentName);
+                bool addMany(QString companyName, QStringList environmentNames, QList<bool> *added = 0);
+                bool replaceAll(QString companyName, QStringList environmentNames, QList<bool> *added = 0);
                 bool has(QString companyName, QString environmentName);
                 bool remove(QString companyName, QString environmentName);
                 bool clear(QString companyName);
@@ -26,8 +49,31 @@ namespace Bidstack {
                 QVariantList all(QString companyName);
                 QVariantList all();
 
+                void setSyncInterval(int msecs);
+
             protected:
                 void init();
+
+            private:
+                bool insertMany(QString companyName, QStringList environmentNames, QList<bool> *added);
+                void load();
+                void sync();
+                qint64 dataVersion();
+
+            private:
+                struct SyncState {
+                    qint64 dataVersion;
+                    QElapsedTimer lastSync;
+                };
+
+                SyncState* syncState();
+
+            private:
+                QMap<QString, QStringList> m_index;
+                QReadWriteLock m_indexLock;
+                quint64 m_indexVersion;
+                QThreadStorage<SyncState*> m_syncStates;
+                int m_syncInterval;
             };
 
         };
@@ -0,0 +1,186 @@
+#include <QCoreApplication>
+#include <QFile>
+#include <QHostAddress>
+#include <QMetaObject>
+#include <QMutexLocker>
+#include <QSslKey>
+#include <QSslSocket>
+
+#include "mockserver.hpp"
+
+QString MockServer::Request::header(const QString& name) const {
+    QMap<QString, QString>::const_iterator it;
+    for (it = headers.constBegin(); it != headers.constEnd(); ++it) {
+        if (it.key().compare(name, Qt::CaseInsensitive) == 0) {
+            return it.value();
+        }
+    }
+
+    return QString();
+}
+
+MockServer::MockServer(bool secure) : QTcpServer(0) {
+    m_secure = secure;
+    m_connections = 0;
+}
+
+MockServer::~MockServer() {
+    if (m_thread.isRunning()) {
+        QMetaObject::invokeMethod(this, "stop", Qt::BlockingQueuedConnection);
+        m_thread.quit();
+        m_thread.wait();
+    }
+}
+
+QByteArray MockServer::certificate() {
+    QFile file(TEST_DATA_DIR "/localhost.crt");
+    file.open(QIODevice::ReadOnly);
+    return file.readAll();
+}
+
+bool MockServer::start() {
+    m_thread.start();
+    moveToThread(&m_thread);
+
+    bool listening = false;
+    QMetaObject::invokeMethod(this, "listenOnLoopback", Qt::BlockingQueuedConnection, Q_RETURN_ARG(bool, listening));
+
+    return listening;
+}
+
+QString MockServer::url() const {
+    return QString(m_secure ? "https" : "http") + "://127.0.0.1:" + QString::number(serverPort());
+}
+
+void MockServer::enqueue(int status, const QByteArray& body, const QMap<QString, QString>& headers) {
+    Response response;
+    response.status = status;
+    response.headers = headers;
+    response.body = body;
+
+    QMutexLocker locker(&m_mutex);
+    m_responses.append(response);
+}
+
+QList<MockServer::Request> MockServer::requests() const {
+    QMutexLocker locker(&m_mutex);
+    return m_requests;
+}
+
+int MockServer::connections() const {
+    QMutexLocker locker(&m_mutex);
+    return m_connections;
+}
+
+void MockServer::incomingConnection(qintptr socketDescriptor) {
+    QTcpSocket *socket;
+
+    if (m_secure) {
+        QFile key(TEST_DATA_DIR "/localhost.key");
+        key.open(QIODevice::ReadOnly);
+
+        QSslSocket *secureSocket = new QSslSocket(this);
+        secureSocket->setSocketDescriptor(socketDescriptor);
+        secureSocket->setLocalCertificate(QSslCertificate(certificate()));
+        secureSocket->setPrivateKey(QSslKey(key.readAll(), QSsl::Rsa));
+        secureSocket->startServerEncryption();
+        socket = secureSocket;
+    } else {
+        socket = new QTcpSocket(this);
+        socket->setSocketDescriptor(socketDescriptor);
+    }
+
+    connect(socket, SIGNAL(readyRead()), this, SLOT(readRequest()));
+
+    QMutexLocker locker(&m_mutex);
+    m_ids.insert(socket, ++m_connections);
+}
+
+bool MockServer::listenOnLoopback() {
+    return listen(QHostAddress::LocalHost, 0);
+}
+
+void MockServer::stop() {
+    close();
+
+    foreach (QTcpSocket *socket, m_ids.keys()) {
+        socket->abort();
+        delete socket;
+    }
+
+    m_ids.clear();
+    m_buffers.clear();
+
+    // Hands the server back so it can be destroyed by the test thread.
+    moveToThread(QCoreApplication::instance()->thread());
+}
+
+void MockServer::readRequest() {
+    QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+    if (!socket) {
+        return;
+    }
+
+    QByteArray& buffer = m_buffers[socket];
+    buffer += socket->readAll();
+
+    forever {
+        int end = buffer.indexOf("\r\n\r\n");
+        if (end < 0) {
+            return;
+        }
+
+        QList<QByteArray> lines = buffer.left(end).split('\n');
+        QList<QByteArray> requestLine = lines.takeFirst().trimmed().split(' ');
+
+        Request request;
+        request.method = requestLine.value(0);
+        request.path = requestLine.value(1);
+        request.connection = m_ids.value(socket);
+
+        foreach (const QByteArray& line, lines) {
+            int separator = line.indexOf(':');
+            if (separator > 0) {
+                request.headers.insert(QString::fromLatin1(line.left(separator).trimmed()), QString::fromUtf8(line.mid(separator + 1).trimmed()));
+            }
+        }
+
+        int length = request.header("Content-Length").toInt();
+        if (buffer.size() < end + 4 + length) {
+            return;
+        }
+
+        request.body = buffer.mid(end + 4, length);
+        buffer.remove(0, end + 4 + length);
+
+        QMutexLocker locker(&m_mutex);
+        m_requests.append(request);
+
+        Response response;
+        if (m_responses.isEmpty()) {
+            response.status = 404;
+        } else {
+            response = m_responses.takeFirst();
+        }
+        locker.unlock();
+
+        QByteArray data = "HTTP/1.1 " + QByteArray::number(response.status) + " Mock\r\n";
+
+        QMap<QString, QString>::const_iterator it;
+        for (it = response.headers.constBegin(); it != response.headers.constEnd(); ++it) {
+            data += it.key().toUtf8() + ": " + it.value().toUtf8() + "\r\n";
+        }
+
+        if (response.status != 304) {
+            data += "Content-Length: " + QByteArray::number(response.body.size()) + "\r\n";
+        }
+
+        data += "\r\n";
+
+        if (response.status != 304) {
+            data += response.body;
+        }
+
+        socket->write(data);
+    }
+}
@@ -0,0 +1,77 @@
+#ifndef BIDSTACK_GIANTSWARM_TESTS_MOCKSERVER_HPP
+#define BIDSTACK_GIANTSWARM_TESTS_MOCKSERVER_HPP
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThread>
+
+/**
+ * Stand-in for the API on 127.0.0.1, optionally over TLS with the
+ * certificate in tests/data. It runs in a thread of its own, so the
+ * client can block on it from the test thread.
+ *
+ * Responses are served in the order they were enqueued, 404 once none
+ * are left. Connections are kept alive.
+ */
+class MockServer : public QTcpServer {
+    Q_OBJECT
+
+public:
+    struct Request {
+        QByteArray method;
+        QByteArray path;
+        QMap<QString, QString> headers;
+        QByteArray body;
+        int connection;
+
+        QString header(const QString& name) const;
+    };
+
+    struct Response {
+        int status;
+        QMap<QString, QString> headers;
+        QByteArray body;
+    };
+
+public:
+    MockServer(bool secure = false);
+    ~MockServer();
+
+public:
+    static QByteArray certificate();
+
+    bool start();
+    QString url() const;
+
+    void enqueue(int status, const QByteArray& body, const QMap<QString, QString>& headers = QMap<QString, QString>());
+    QList<Request> requests() const;
+    int connections() const;
+
+protected:
+    void incomingConnection(qintptr socketDescriptor);
+
+private slots:
+    bool listenOnLoopback();
+    void stop();
+    void readRequest();
+
+private:
+    bool m_secure;
+    QThread m_thread;
+
+    mutable QMutex m_mutex;
+    QList<Response> m_responses;
+    QList<Request> m_requests;
+    int m_connections;
+
+    QHash<QTcpSocket*, QByteArray> m_buffers;
+    QHash<QTcpSocket*, int> m_ids;
+};
+
+#endif
@@ -0,0 +1,5 @@
+TARGET = tst_conditionalget
+
+include(../tests.pri)
+
+SOURCES += tst_conditionalget.cpp
@@ -0,0 +1,190 @@
+#include <QHash>
+#include <QSqlDatabase>
+#include <QtTest>
+
+#include "giantswarmcacheentry.hpp"
+#include "giantswarmclient.hpp"
+#include "mockserver.hpp"
+
+#include "deps/cache/abstractcacheadapter.hpp"
+
+using namespace Bidstack::Cache;
+using namespace Bidstack::Giantswarm;
+
+namespace {
+
+    const char *USER_ALICE = "{\"status_code\": 10000, \"data\": {\"username\": \"alice\", \"email\": \"alice@example.com\"}}";
+    const char *USER_BOB = "{\"status_code\": 10000, \"data\": {\"username\": \"bob\", \"email\": \"bob@example.com\"}}";
+    const char *LAST_MODIFIED = "Sat, 17 Oct 2026 10:00:00 GMT";
+
+    /**
+     * Keeps everything stored so the test can look at the cache entries.
+     */
+    class RecordingCacheAdapter : public AbstractCacheAdapter {
+    public:
+        bool has(QString key) {
+            return values.contains(key);
+        }
+
+        QString fetch(QString key) {
+            return values.value(key);
+        }
+
+        void store(QString key, QString value) {
+            values.insert(key, value);
+        }
+
+        /**
+         * The stored responses, leaving out the generations the client
+         * keeps next to them.
+         */
+        QList<GiantswarmCacheEntry> entries() const {
+            QList<GiantswarmCacheEntry> entries;
+
+            QHash<QString, QString>::const_iterator it;
+            for (it = values.constBegin(); it != values.constEnd(); ++it) {
+                if (!it.key().startsWith("giantswarm_generation_")) {
+                    GiantswarmCacheEntry entry;
+                    entry.fromCachableString(it.value());
+                    entries.append(entry);
+                }
+            }
+
+            return entries;
+        }
+
+        GiantswarmCacheEntry entry() const {
+            QList<GiantswarmCacheEntry> all = entries();
+            return all.size() == 1 ? all.first() : GiantswarmCacheEntry();
+        }
+
+        QHash<QString, QString> values;
+    };
+
+    QMap<QString, QString> validators(const QString& etag) {
+        QMap<QString, QString> headers;
+        headers["ETag"] = etag;
+        headers["Last-Modified"] = LAST_MODIFIED;
+        return headers;
+    }
+
+};
+
+/**
+ * Expired cache entries are revalidated with the validators of the
+ * response they were created from.
+ */
+class TestConditionalGet : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+    void cleanupTestCase();
+
+    void sendsValidators();
+    void refreshesEntryOnNotModified();
+    void replacesEntryOnSuccess();
+
+private:
+    void primeAndExpire();
+
+private:
+    QSqlDatabase m_database;
+    MockServer *m_server;
+    RecordingCacheAdapter *m_cache;
+    GiantswarmClient *m_client;
+};
+
+void TestConditionalGet::initTestCase() {
+    m_database = QSqlDatabase::addDatabase("QSQLITE", "conditionalget");
+    m_database.setDatabaseName(":memory:");
+    QVERIFY(m_database.open());
+}
+
+void TestConditionalGet::init() {
+    m_server = new MockServer();
+    QVERIFY(m_server->start());
+
+    m_cache = new RecordingCacheAdapter();
+
+    m_client = new GiantswarmClient(m_database);
+    m_client->setEndpoint(m_server->url());
+    m_client->setCache(m_cache);
+    m_client->setCachePolicy(GiantswarmEndpoint::User, GiantswarmCachePolicy(1));
+    m_client->setToken("secret");
+}
+
+void TestConditionalGet::cleanup() {
+    delete m_client;
+    delete m_cache;
+    delete m_server;
+}
+
+void TestConditionalGet::cleanupTestCase() {
+    m_database.close();
+    m_database = QSqlDatabase();
+    QSqlDatabase::removeDatabase("conditionalget");
+}
+
+/**
+ * Caches alice's user and waits until the entry has expired.
+ */
+void TestConditionalGet::primeAndExpire() {
+    m_server->enqueue(200, USER_ALICE, validators("\"v1\""));
+    QCOMPARE(m_client->getUser().value("name").toString(), QString("alice"));
+    QCOMPARE(m_cache->entries().size(), 1);
+
+    QTest::qSleep(1100);
+}
+
+void TestConditionalGet::sendsValidators() {
+    primeAndExpire();
+
+    m_server->enqueue(304, QByteArray(), validators("\"v1\""));
+    m_client->getUser();
+
+    QList<MockServer::Request> requests = m_server->requests();
+    QCOMPARE(requests.size(), 2);
+
+    QVERIFY(requests.at(0).header("If-None-Match").isEmpty());
+    QVERIFY(requests.at(0).header("If-Modified-Since").isEmpty());
+
+    QCOMPARE(requests.at(1).header("If-None-Match"), QString("\"v1\""));
+    QCOMPARE(requests.at(1).header("If-Modified-Since"), QString(LAST_MODIFIED));
+}
+
+void TestConditionalGet::refreshesEntryOnNotModified() {
+    primeAndExpire();
+
+    GiantswarmCacheEntry before = m_cache->entry();
+    QCOMPARE(before.body(), QByteArray(USER_ALICE));
+
+    m_server->enqueue(304, QByteArray(), validators("\"v1\""));
+    QCOMPARE(m_client->getUser().value("name").toString(), QString("alice"));
+
+    GiantswarmCacheEntry after = m_cache->entry();
+    QCOMPARE(after.status(), before.status());
+    QCOMPARE(after.body(), before.body());
+    QVERIFY(after.storedAt() > before.storedAt());
+
+    // Fresh again, so served without another request.
+    QCOMPARE(m_client->getUser().value("name").toString(), QString("alice"));
+    QCOMPARE(m_server->requests().size(), 2);
+}
+
+void TestConditionalGet::replacesEntryOnSuccess() {
+    primeAndExpire();
+
+    m_server->enqueue(200, USER_BOB, validators("\"v2\""));
+    QCOMPARE(m_client->getUser().value("name").toString(), QString("bob"));
+
+    GiantswarmCacheEntry entry = m_cache->entry();
+    QCOMPARE(entry.body(), QByteArray(USER_BOB));
+    QCOMPARE(entry.header("ETag"), QString("\"v2\""));
+}
+
+QTEST_GUILESS_MAIN(TestConditionalGet)
+
+#include "tst_conditionalget.moc"
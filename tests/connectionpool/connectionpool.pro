@@ -0,0 +1,5 @@
+TARGET = tst_connectionpool
+
+include(../tests.pri)
+
+SOURCES += tst_connectionpool.cpp
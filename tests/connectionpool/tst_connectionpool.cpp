@@ -0,0 +1,170 @@
+#include <QRunnable>
+#include <QSslCertificate>
+#include <QSslConfiguration>
+#include <QSslSocket>
+#include <QThreadPool>
+#include <QtTest>
+
+#include "giantswarmconnectionpool.hpp"
+#include "mockserver.hpp"
+
+using namespace Bidstack::Giantswarm;
+
+namespace {
+
+    int get(GiantswarmConnectionPool *pool, const QString& url) {
+        GiantswarmConnectionPool::Lease lease(pool, url);
+        GiantswarmConnection::Response response;
+
+        if (!lease.connection()->send("GET", QUrl(url), QMap<QString, QString>(), QByteArray(), &response)) {
+            return -1;
+        }
+
+        return response.status;
+    }
+
+    /**
+     * Requests once from a thread that has not used the pool before and
+     * records the session ticket its new connection offers.
+     */
+    class Worker : public QRunnable {
+    public:
+        Worker(GiantswarmConnectionPool *pool, const QString& url) {
+            m_pool = pool;
+            m_url = url;
+            status = 0;
+            setAutoDelete(false);
+        }
+
+        void run() {
+            {
+                GiantswarmConnectionPool::Lease lease(m_pool, m_url);
+                offeredTicket = lease.connection()->sessionTicket();
+            }
+
+            status = get(m_pool, m_url);
+        }
+
+        int status;
+        QByteArray offeredTicket;
+
+    private:
+        GiantswarmConnectionPool *m_pool;
+        QString m_url;
+    };
+
+};
+
+class TestConnectionPool : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void reusesConnection();
+    void sharesSessionTicketBetweenThreads();
+    void reconnectsAfterIdleTimeout();
+    void keepsConnectionsWithoutIdleTimeout();
+
+private:
+    QSslConfiguration m_configuration;
+};
+
+void TestConnectionPool::initTestCase() {
+    if (!QSslSocket::supportsSsl()) {
+        QSKIP("No TLS support available");
+    }
+
+    m_configuration = QSslConfiguration::defaultConfiguration();
+    m_configuration.setCaCertificates(QList<QSslCertificate>() << QSslCertificate(MockServer::certificate()));
+}
+
+void TestConnectionPool::reusesConnection() {
+    MockServer server(true);
+    QVERIFY(server.start());
+
+    GiantswarmConnectionPool pool;
+    pool.setSslConfiguration(m_configuration);
+
+    for (int i = 0; i < 5; ++i) {
+        server.enqueue(200, "ok");
+        QCOMPARE(get(&pool, server.url() + "/ping"), 200);
+    }
+
+    QCOMPARE(server.requests().size(), 5);
+    QCOMPARE(server.connections(), 1);
+}
+
+/**
+ * A stand-in server built on QSslSocket gets a new session ticket key with
+ * every connection, so it cannot actually resume sessions; what is
+ * checked is that the ticket of the first connection is kept and offered
+ * by every new connection to the same origin, which is what lets a real
+ * server skip the full handshake.
+ */
+void TestConnectionPool::sharesSessionTicketBetweenThreads() {
+    MockServer server(true);
+    QVERIFY(server.start());
+
+    GiantswarmConnectionPool pool;
+    pool.setSslConfiguration(m_configuration);
+
+    server.enqueue(200, "ok");
+    QCOMPARE(get(&pool, server.url() + "/ping"), 200);
+
+    QByteArray ticket = pool.sessionTicket(server.url());
+    QVERIFY(!ticket.isEmpty());
+
+    server.enqueue(200, "ok");
+
+    QThreadPool threads;
+    Worker worker(&pool, server.url() + "/ping");
+    threads.start(&worker);
+    threads.waitForDone();
+
+    QCOMPARE(worker.status, 200);
+    QCOMPARE(worker.offeredTicket, ticket);
+    QCOMPARE(server.connections(), 2);
+}
+
+void TestConnectionPool::reconnectsAfterIdleTimeout() {
+    MockServer server(true);
+    QVERIFY(server.start());
+
+    GiantswarmConnectionPool pool;
+    pool.setSslConfiguration(m_configuration);
+    pool.setIdleTimeout(1);
+
+    server.enqueue(200, "ok");
+    QCOMPARE(get(&pool, server.url() + "/ping"), 200);
+
+    QTest::qSleep(1100);
+
+    server.enqueue(200, "ok");
+    QCOMPARE(get(&pool, server.url() + "/ping"), 200);
+
+    QCOMPARE(server.connections(), 2);
+}
+
+void TestConnectionPool::keepsConnectionsWithoutIdleTimeout() {
+    MockServer server(true);
+    QVERIFY(server.start());
+
+    GiantswarmConnectionPool pool;
+    pool.setSslConfiguration(m_configuration);
+    pool.setIdleTimeout(0);
+
+    server.enqueue(200, "ok");
+    QCOMPARE(get(&pool, server.url() + "/ping"), 200);
+
+    QTest::qSleep(1100);
+
+    server.enqueue(200, "ok");
+    QCOMPARE(get(&pool, server.url() + "/ping"), 200);
+
+    QCOMPARE(server.connections(), 1);
+}
+
+QTEST_GUILESS_MAIN(TestConnectionPool)
+
+#include "tst_connectionpool.moc"
@@ -0,0 +1,32 @@
+# Builds a test against the library sources and the bundled dependencies.
+lessThan(QT_MAJOR_VERSION, 5): error("The tests require Qt 5")
+
+QT += core network sql testlib
+QT -= gui
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+ROOT = $$PWD/..
+
+INCLUDEPATH += $$ROOT $$PWD/common
+DEFINES += TEST_DATA_DIR=\\\"$$PWD/data\\\"
+
+HEADERS += \
+    $$files($$ROOT/*.hpp) \
+    $$files($$ROOT/caches/*.hpp) \
+    $$files($$ROOT/jobs/*.hpp) \
+    $$files($$ROOT/repositories/*.hpp) \
+    $$files($$ROOT/deps/http/*.hpp) \
+    $$files($$ROOT/deps/cache/*.hpp) \
+    $$files($$ROOT/deps/qjson4/*.h) \
+    $$PWD/common/mockserver.hpp
+
+SOURCES += \
+    $$files($$ROOT/*.cpp) \
+    $$files($$ROOT/caches/*.cpp) \
+    $$files($$ROOT/jobs/*.cpp) \
+    $$files($$ROOT/repositories/*.cpp) \
+    $$files($$ROOT/deps/http/*.cpp) \
+    $$files($$ROOT/deps/cache/*.cpp) \
+    $$files($$ROOT/deps/qjson4/*.cpp) \
+    $$PWD/common/mockserver.cpp